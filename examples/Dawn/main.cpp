@@ -16,11 +16,14 @@
 // and heavily modified for this example
 
 #include <webgpu/webgpu_cpp.h>
+#include <emscripten/emscripten.h>
 #include <emscripten/html5.h>
+#include <algorithm>
+#include <cmath>
 #include <functional>
-
-const uint32_t kWidth = 300;
-const uint32_t kHeight = 150;
+#include <map>
+#include <string>
+#include <vector>
 
 void terminate(std::string_view iMessage)
 {
@@ -53,20 +56,202 @@ private:
   wgpu::Queue fQueue{};
 };
 
+// Describes a render pipeline: the WGSL source and the (subset of the) descriptor used by this example.
+// The cache looks a pipeline up by the hash of all the fields, and compares the whole key on a hit.
+struct RenderPipelineKey
+{
+  std::string fWGSL{};
+  std::string fVertexEntryPoint{"main_v"};
+  std::string fFragmentEntryPoint{"main_f"};
+  uint32_t fLayoutId{}; // returned by PipelineCache::addLayout (0 means "auto" layout)
+  wgpu::TextureFormat fColorFormat{wgpu::TextureFormat::BGRA8Unorm};
+  wgpu::TextureFormat fDepthStencilFormat{wgpu::TextureFormat::Undefined};
+  bool fDepthWriteEnabled{false};
+  wgpu::CompareFunction fDepthCompare{wgpu::CompareFunction::Always};
+  wgpu::PrimitiveTopology fTopology{wgpu::PrimitiveTopology::TriangleList};
+
+  uint64_t hash() const;
+  bool operator==(RenderPipelineKey const &iOther) const;
+};
+
+// Creates the render pipelines asynchronously (CreateRenderPipelineAsync) so that they are compiled in parallel,
+// and keeps them for the rest of the session:
+// - shader modules are shared between pipelines using the same WGSL
+// - requesting a pipeline which is already created (or being created) does not create it again
+// - the pipeline layouts are registered in the cache (which keeps them alive) and identified by an id, so that a
+//   layout is never mistaken for another one allocated at the same address
+// - a pipeline which fails to be created is reported to the requests waiting for it and removed from the cache
+class PipelineCache
+{
+public:
+  using OnPipeline = std::function<void(wgpu::RenderPipeline const &iPipeline)>;
+  using OnError = std::function<void(wgpu::StringView iMessage)>;
+
+  explicit PipelineCache(std::shared_ptr<GPU> iGPU) : fGPU{std::move(iGPU)} {}
+
+  // returns the id to use in RenderPipelineKey::fLayoutId
+  uint32_t addLayout(wgpu::PipelineLayout iLayout)
+  {
+    fLayouts.emplace_back(std::move(iLayout));
+    return static_cast<uint32_t>(fLayouts.size());
+  }
+
+  // iOnPipeline is called when the pipeline is ready (immediately if it is already in the cache), iOnError if it
+  // cannot be created
+  void request(RenderPipelineKey const &iKey, OnPipeline iOnPipeline, OnError iOnError);
+
+  // requests a pipeline which is not needed right away (ex: for a later frame). An error is only printed.
+  void prewarm(RenderPipelineKey const &iKey) { request(iKey, {}, {}); }
+
+  int getRequestCount() const { return fRequestCount; }
+  int getPipelineCount() const { return fPipelineCount; }
+  int getShaderModuleCount() const { return static_cast<int>(fShaderModules.size()); }
+
+private:
+  wgpu::ShaderModule const &getShaderModule(std::string const &iWGSL);
+
+  struct Request
+  {
+    OnPipeline fOnPipeline{};
+    OnError fOnError{};
+  };
+
+  struct Entry
+  {
+    RenderPipelineKey fKey{};
+    wgpu::RenderPipeline fPipeline{};
+    std::vector<Request> fPending{};
+  };
+
+  void onPipelineError(uint64_t iHash, std::shared_ptr<Entry> const &iEntry, wgpu::StringView iMessage);
+
+private:
+  std::shared_ptr<GPU> fGPU;
+  std::vector<wgpu::PipelineLayout> fLayouts{};
+  std::map<std::string, wgpu::ShaderModule> fShaderModules{};
+  // entries by hash of their key (a hash collision puts several entries in the same bucket)
+  std::map<uint64_t, std::vector<std::shared_ptr<Entry>>> fPipelines{};
+  int fPipelineCount{};
+  int fRequestCount{};
+};
+
+// Counts the wgpu calls made per frame: with emdawnwebgpu, each call (including the releases done by the wgpu::
+// destructors) crosses the wasm/JS boundary. The render paths make their calls through call() and release their
+// objects through release(), so that the count follows the code.
+class CallCounter
+{
+public:
+  template<typename Call>
+  decltype(auto) call(Call &&iCall)
+  {
+    fCalls++;
+    return iCall();
+  }
+
+  template<typename Object>
+  void release(Object &ioObject)
+  {
+    if(ioObject)
+    {
+      fCalls++;
+      ioObject = Object{};
+    }
+  }
+
+  void endFrame() { fFrames++; }
+  double perFrame() const { return fFrames == 0 ? 0 : static_cast<double>(fCalls) / fFrames; }
+
+private:
+  int fCalls{};
+  int fFrames{};
+};
+
+// Coalesces the size changes of the canvas so that the surface and the attachments depending on its size are
+// reallocated once per settled size, instead of on every frame of an interactive resize (the browser stretches the
+// canvas content in the meantime):
+// - the canvas fills the window: its css size follows the window right away (no GPU allocation)
+// - its size in pixels (css size * devicePixelRatio, capped to kMaxPixelRatio and maxTextureDimension2D) is only
+//   applied once the window size has not changed for kSettleDelayMs: each resize event restarts a timer, so nothing
+//   needs to poll the size (the main loop can be stopped)
+class ResizeCoordinator
+{
+public:
+  static constexpr double kSettleDelayMs = 150;
+  static constexpr double kMaxPixelRatio = 2.0;
+
+  struct Size
+  {
+    uint32_t fWidth{};
+    uint32_t fHeight{};
+
+    bool operator==(Size const &iOther) const { return fWidth == iOther.fWidth && fHeight == iOther.fHeight; }
+    bool operator!=(Size const &iOther) const { return !(*this == iOther); }
+  };
+
+  using OnSizeSettled = std::function<void(Size iSize)>;
+
+  // computes the initial size and starts listening to the window resize events: iOnSizeSettled is called when the
+  // size has settled on a new value, which must be applied
+  void init(uint32_t iMaxDimension, OnSizeSettled iOnSizeSettled);
+
+  Size getSize() const { return fSize; }
+  int getEventCount() const { return fEventCount; }
+  int getResizeCount() const { return fResizeCount; }
+
+private:
+  void setWindowSize(int iWindowWidth, int iWindowHeight);
+  void onWindowResized(int iWindowWidth, int iWindowHeight);
+  void onSettled();
+  Size computeSize() const;
+
+private:
+  uint32_t fMaxDimension{};
+  OnSizeSettled fOnSizeSettled{};
+  int fCssWidth{};
+  int fCssHeight{};
+  double fPixelRatio{1.0};
+  Size fSize{};
+  int fSettleTimeout{}; // 0 when no timer is pending
+  int fEventCount{};
+  int fResizeCount{};
+};
+
 class Renderer
 {
 public:
-  explicit Renderer(std::shared_ptr<GPU> iGPU) : fGPU{std::move(iGPU)} {}
-  void init();
+  explicit Renderer(std::shared_ptr<GPU> iGPU) : fGPU{iGPU}, fPipelineCache{std::move(iGPU)} {}
+  Renderer(Renderer const &) = delete;
+  Renderer &operator=(Renderer const &) = delete;
+
+  // onReady is called when the pipelines needed for the first frame are created, onError if one of them cannot be
+  // created
+  void asyncInit(ResizeCoordinator::Size iSize, std::function<void()> onReady,
+                 std::function<void(wgpu::StringView)> onError);
+  void resize(ResizeCoordinator::Size iSize);
   void render(int iFrame);
+  void renderWithoutCache(int iFrame);
+  void printStats() const;
+
+private:
+  void initFrameResources();
 
 private:
 
   std::shared_ptr<GPU> fGPU;
+  PipelineCache fPipelineCache;
 
   wgpu::RenderPipeline fRenderPipeline{};
   wgpu::Surface fSurface{};
   wgpu::TextureView fCanvasDepthStencilView{};
+
+  // frame resources (built once in initFrameResources)
+  wgpu::RenderPassColorAttachment fColorAttachment{};
+  wgpu::RenderPassDepthStencilAttachment fDepthStencilAttachment{};
+  wgpu::RenderPassDescriptor fRenderPassDescriptor{};
+  wgpu::RenderBundle fRenderBundle{};
+
+  CallCounter fCachedCalls{};
+  CallCounter fUncachedCalls{};
 };
 
 //------------------------------------------------------------------------
@@ -152,66 +337,187 @@ static const char shaderCode[] = R"(
 )";
 
 //------------------------------------------------------------------------
-// Renderer::init
+// hash (FNV-1a)
 //------------------------------------------------------------------------
-void Renderer::init()
+static uint64_t hash(uint64_t iHash, void const *iData, size_t iSize)
 {
-  wgpu::ShaderModule shaderModule{};
+  auto bytes = static_cast<uint8_t const *>(iData);
+  for(size_t i = 0; i < iSize; i++)
+  {
+    iHash ^= bytes[i];
+    iHash *= 1099511628211ull;
+  }
+  return iHash;
+}
+
+static constexpr uint64_t kHashSeed = 14695981039346656037ull;
+
+static uint64_t hash(uint64_t iHash, std::string const &iString)
+{
+  // includes the terminating 0 so that consecutive strings cannot produce the same bytes
+  return hash(iHash, iString.c_str(), iString.size() + 1);
+}
+
+//------------------------------------------------------------------------
+// RenderPipelineKey::hash
+//------------------------------------------------------------------------
+uint64_t RenderPipelineKey::hash() const
+{
+  auto res = ::hash(kHashSeed, fWGSL);
+  res = ::hash(res, fVertexEntryPoint);
+  res = ::hash(res, fFragmentEntryPoint);
+  res = ::hash(res, &fLayoutId, sizeof(fLayoutId));
+  res = ::hash(res, &fColorFormat, sizeof(fColorFormat));
+  res = ::hash(res, &fDepthStencilFormat, sizeof(fDepthStencilFormat));
+  res = ::hash(res, &fDepthWriteEnabled, sizeof(fDepthWriteEnabled));
+  res = ::hash(res, &fDepthCompare, sizeof(fDepthCompare));
+  res = ::hash(res, &fTopology, sizeof(fTopology));
+  return res;
+}
+
+//------------------------------------------------------------------------
+// RenderPipelineKey::operator==
+//------------------------------------------------------------------------
+bool RenderPipelineKey::operator==(RenderPipelineKey const &iOther) const
+{
+  return fWGSL == iOther.fWGSL &&
+         fVertexEntryPoint == iOther.fVertexEntryPoint &&
+         fFragmentEntryPoint == iOther.fFragmentEntryPoint &&
+         fLayoutId == iOther.fLayoutId &&
+         fColorFormat == iOther.fColorFormat &&
+         fDepthStencilFormat == iOther.fDepthStencilFormat &&
+         fDepthWriteEnabled == iOther.fDepthWriteEnabled &&
+         fDepthCompare == iOther.fDepthCompare &&
+         fTopology == iOther.fTopology;
+}
+
+//------------------------------------------------------------------------
+// PipelineCache::getShaderModule
+//------------------------------------------------------------------------
+wgpu::ShaderModule const &PipelineCache::getShaderModule(std::string const &iWGSL)
+{
+  auto &module = fShaderModules[iWGSL];
+  if(!module)
   {
     wgpu::ShaderSourceWGSL wgslDesc{};
-    wgslDesc.code = shaderCode;
+    wgslDesc.code = iWGSL.c_str();
 
     wgpu::ShaderModuleDescriptor descriptor{};
     descriptor.nextInChain = &wgslDesc;
-    shaderModule = fGPU->device().CreateShaderModule(&descriptor);
+    module = fGPU->device().CreateShaderModule(&descriptor);
   }
+  return module;
+}
 
-  {
-    wgpu::BindGroupLayoutDescriptor bglDesc{};
-    auto bgl = fGPU->device().CreateBindGroupLayout(&bglDesc);
-    wgpu::BindGroupDescriptor desc{};
-    desc.layout = bgl;
-    desc.entryCount = 0;
-    desc.entries = nullptr;
-    fGPU->device().CreateBindGroup(&desc);
-  }
+//------------------------------------------------------------------------
+// PipelineCache::request
+//------------------------------------------------------------------------
+void PipelineCache::request(RenderPipelineKey const &iKey, OnPipeline iOnPipeline, OnError iOnError)
+{
+  fRequestCount++;
 
+  auto hash = iKey.hash();
+  auto &bucket = fPipelines[hash];
+  for(auto const &existing: bucket)
   {
-    wgpu::PipelineLayoutDescriptor pl{};
-    pl.bindGroupLayoutCount = 0;
-    pl.bindGroupLayouts = nullptr;
+    if(!(existing->fKey == iKey))
+      continue;
+    if(existing->fPipeline)
+    {
+      if(iOnPipeline)
+        iOnPipeline(existing->fPipeline);
+    }
+    else
+      existing->fPending.emplace_back(Request{std::move(iOnPipeline), std::move(iOnError)});
+    return;
+  }
 
-    wgpu::ColorTargetState colorTargetState{};
-    colorTargetState.format = wgpu::TextureFormat::BGRA8Unorm;
-
-    wgpu::FragmentState fragmentState{};
-    fragmentState.module = shaderModule;
-    fragmentState.entryPoint = "main_f";
-    fragmentState.targetCount = 1;
-    fragmentState.targets = &colorTargetState;
-
-    wgpu::DepthStencilState depthStencilState{};
-    depthStencilState.format = wgpu::TextureFormat::Depth32Float;
-    depthStencilState.depthWriteEnabled = true;
-    depthStencilState.depthCompare = wgpu::CompareFunction::Always;
-
-    wgpu::RenderPipelineDescriptor descriptor{};
-    descriptor.layout = fGPU->device().CreatePipelineLayout(&pl);
-    descriptor.vertex.module = shaderModule;
-    descriptor.vertex.entryPoint = "main_v";
-    descriptor.fragment = &fragmentState;
-    descriptor.primitive.topology = wgpu::PrimitiveTopology::TriangleList;
+  auto entry = std::make_shared<Entry>();
+  entry->fKey = iKey;
+  entry->fPending.emplace_back(Request{std::move(iOnPipeline), std::move(iOnError)});
+  bucket.emplace_back(entry);
+  fPipelineCount++;
+
+  auto const &shaderModule = getShaderModule(iKey.fWGSL);
+
+  wgpu::ColorTargetState colorTargetState{};
+  colorTargetState.format = iKey.fColorFormat;
+
+  wgpu::FragmentState fragmentState{};
+  fragmentState.module = shaderModule;
+  fragmentState.entryPoint = iKey.fFragmentEntryPoint.c_str();
+  fragmentState.targetCount = 1;
+  fragmentState.targets = &colorTargetState;
+
+  wgpu::DepthStencilState depthStencilState{};
+  depthStencilState.format = iKey.fDepthStencilFormat;
+  depthStencilState.depthWriteEnabled = iKey.fDepthWriteEnabled;
+  depthStencilState.depthCompare = iKey.fDepthCompare;
+
+  wgpu::RenderPipelineDescriptor descriptor{};
+  if(iKey.fLayoutId > 0)
+    descriptor.layout = fLayouts[iKey.fLayoutId - 1];
+  descriptor.vertex.module = shaderModule;
+  descriptor.vertex.entryPoint = iKey.fVertexEntryPoint.c_str();
+  descriptor.fragment = &fragmentState;
+  descriptor.primitive.topology = iKey.fTopology;
+  if(iKey.fDepthStencilFormat != wgpu::TextureFormat::Undefined)
     descriptor.depthStencil = &depthStencilState;
 
-    fRenderPipeline = fGPU->device().CreateRenderPipeline(&descriptor);
+  fGPU->device().CreateRenderPipelineAsync(&descriptor, wgpu::CallbackMode::AllowSpontaneous,
+                                           [this, hash, entry](wgpu::CreatePipelineAsyncStatus status,
+                                                               wgpu::RenderPipeline pipeline,
+                                                               wgpu::StringView message) {
+                                             if(status != wgpu::CreatePipelineAsyncStatus::Success)
+                                             {
+                                               onPipelineError(hash, entry, message);
+                                               return;
+                                             }
+                                             entry->fPipeline = std::move(pipeline);
+                                             auto pending = std::move(entry->fPending);
+                                             for(auto &request: pending)
+                                             {
+                                               if(request.fOnPipeline)
+                                                 request.fOnPipeline(entry->fPipeline);
+                                             }
+                                           });
+}
+
+//------------------------------------------------------------------------
+// PipelineCache::onPipelineError
+// The entry is removed from the cache (a later request tries again) before the requests are notified
+//------------------------------------------------------------------------
+void PipelineCache::onPipelineError(uint64_t iHash, std::shared_ptr<Entry> const &iEntry, wgpu::StringView iMessage)
+{
+  auto &bucket = fPipelines[iHash];
+  bucket.erase(std::remove(bucket.begin(), bucket.end(), iEntry), bucket.end());
+  if(bucket.empty())
+    fPipelines.erase(iHash);
+  fPipelineCount--;
+
+  printf("CreateRenderPipelineAsync error: %.*s\n", static_cast<int>(iMessage.length), iMessage.data);
+  auto pending = std::move(iEntry->fPending);
+  for(auto &request: pending)
+  {
+    if(request.fOnError)
+      request.fOnError(iMessage);
   }
+}
 
+//------------------------------------------------------------------------
+// Renderer::asyncInit
+//------------------------------------------------------------------------
+void Renderer::asyncInit(ResizeCoordinator::Size iSize, std::function<void()> onReady,
+                         std::function<void(wgpu::StringView)> onError)
+{
   {
-    wgpu::TextureDescriptor descriptor{};
-    descriptor.usage = wgpu::TextureUsage::RenderAttachment;
-    descriptor.size = {kWidth, kHeight, 1};
-    descriptor.format = wgpu::TextureFormat::Depth32Float;
-    fCanvasDepthStencilView = fGPU->device().CreateTexture(&descriptor).CreateView();
+    wgpu::BindGroupLayoutDescriptor bglDesc{};
+    auto bgl = fGPU->device().CreateBindGroupLayout(&bglDesc);
+    wgpu::BindGroupDescriptor desc{};
+    desc.layout = bgl;
+    desc.entryCount = 0;
+    desc.entries = nullptr;
+    fGPU->device().CreateBindGroup(&desc);
   }
 
   {
@@ -221,20 +527,85 @@ void Renderer::init()
     wgpu::SurfaceDescriptor surfDesc{};
     surfDesc.nextInChain = &canvasDesc;
     fSurface = fGPU->instance().CreateSurface(&surfDesc);
+  }
+
+  // configures the surface and creates the depth attachment
+  resize(iSize);
+
+  {
+    wgpu::PipelineLayoutDescriptor pl{};
+    pl.bindGroupLayoutCount = 0;
+    pl.bindGroupLayouts = nullptr;
 
-    wgpu::SurfaceColorManagement colorManagement{};
-    wgpu::SurfaceConfiguration configuration{};
-    configuration.nextInChain = &colorManagement;
-    configuration.device = fGPU->device();
-    configuration.usage = wgpu::TextureUsage::RenderAttachment;
-    configuration.format = wgpu::TextureFormat::BGRA8Unorm;
-    configuration.width = kWidth;
-    configuration.height = kHeight;
-    configuration.alphaMode = wgpu::CompositeAlphaMode::Premultiplied;
-    configuration.presentMode = wgpu::PresentMode::Fifo;
-    fSurface.Configure(&configuration);
+    RenderPipelineKey key{};
+    key.fWGSL = shaderCode;
+    key.fLayoutId = fPipelineCache.addLayout(fGPU->device().CreatePipelineLayout(&pl));
+    key.fDepthStencilFormat = wgpu::TextureFormat::Depth32Float;
+    key.fDepthWriteEnabled = true;
+
+    // the only pipeline used by this example (the pipelines needed later would be requested with prewarm)
+    fPipelineCache.request(key, [this, onReady = std::move(onReady)](wgpu::RenderPipeline const &iPipeline) {
+      fRenderPipeline = iPipeline;
+      initFrameResources();
+      onReady();
+    }, std::move(onError));
   }
+}
 
+//------------------------------------------------------------------------
+// Renderer::resize
+// The surface and the depth attachment always have the same size: they are reallocated together
+//------------------------------------------------------------------------
+void Renderer::resize(ResizeCoordinator::Size iSize)
+{
+  wgpu::SurfaceColorManagement colorManagement{};
+  wgpu::SurfaceConfiguration configuration{};
+  configuration.nextInChain = &colorManagement;
+  configuration.device = fGPU->device();
+  configuration.usage = wgpu::TextureUsage::RenderAttachment;
+  configuration.format = wgpu::TextureFormat::BGRA8Unorm;
+  configuration.width = iSize.fWidth;
+  configuration.height = iSize.fHeight;
+  configuration.alphaMode = wgpu::CompositeAlphaMode::Premultiplied;
+  configuration.presentMode = wgpu::PresentMode::Fifo;
+  fSurface.Configure(&configuration);
+
+  wgpu::TextureDescriptor descriptor{};
+  descriptor.usage = wgpu::TextureUsage::RenderAttachment;
+  descriptor.size = {iSize.fWidth, iSize.fHeight, 1};
+  descriptor.format = wgpu::TextureFormat::Depth32Float;
+  fCanvasDepthStencilView = fGPU->device().CreateTexture(&descriptor).CreateView();
+  fDepthStencilAttachment.view = fCanvasDepthStencilView;
+}
+
+//------------------------------------------------------------------------
+// Renderer::initFrameResources
+//------------------------------------------------------------------------
+void Renderer::initFrameResources()
+{
+  // the pass descriptor only changes by its color view and clear value
+  fColorAttachment.loadOp = wgpu::LoadOp::Clear;
+  fColorAttachment.storeOp = wgpu::StoreOp::Store;
+
+  fDepthStencilAttachment.view = fCanvasDepthStencilView;
+  fDepthStencilAttachment.depthClearValue = 0;
+  fDepthStencilAttachment.depthLoadOp = wgpu::LoadOp::Clear;
+  fDepthStencilAttachment.depthStoreOp = wgpu::StoreOp::Store;
+
+  fRenderPassDescriptor.colorAttachmentCount = 1;
+  fRenderPassDescriptor.colorAttachments = &fColorAttachment;
+  fRenderPassDescriptor.depthStencilAttachment = &fDepthStencilAttachment;
+
+  // the triangle is static: its commands are recorded once and replayed with a single call every frame
+  wgpu::TextureFormat colorFormat = wgpu::TextureFormat::BGRA8Unorm;
+  wgpu::RenderBundleEncoderDescriptor descriptor{};
+  descriptor.colorFormatCount = 1;
+  descriptor.colorFormats = &colorFormat;
+  descriptor.depthStencilFormat = wgpu::TextureFormat::Depth32Float;
+  auto encoder = fGPU->device().CreateRenderBundleEncoder(&descriptor);
+  encoder.SetPipeline(fRenderPipeline);
+  encoder.Draw(3);
+  fRenderBundle = encoder.Finish();
 }
 
 //------------------------------------------------------------------------
@@ -242,15 +613,47 @@ void Renderer::init()
 //------------------------------------------------------------------------
 void Renderer::render(int iFrame)
 {
-  fGPU->pollEvents();
+  auto &calls = fCachedCalls;
+  calls.call([this] { fGPU->pollEvents(); });
+
+  wgpu::SurfaceTexture surfaceTexture;
+  calls.call([&] { fSurface.GetCurrentTexture(&surfaceTexture); });
+  assert(surfaceTexture.status == wgpu::SurfaceGetCurrentTextureStatus::SuccessOptimal);
+
+  // browsers hand out a new canvas texture every frame: its view cannot be reused
+  fColorAttachment.view = calls.call([&] { return surfaceTexture.texture.CreateView(); });
+  fColorAttachment.clearValue = {0.5, 0.5, iFrame / 60.0, 1};
+
+  auto encoder = calls.call([this] { return fGPU->device().CreateCommandEncoder(); });
+  auto pass = calls.call([&] { return encoder.BeginRenderPass(&fRenderPassDescriptor); });
+  calls.call([&] { pass.ExecuteBundles(1, &fRenderBundle); });
+  calls.call([&] { pass.End(); });
+  auto commands = calls.call([&] { return encoder.Finish(); });
+  calls.call([&] { fGPU->queue().Submit(1, &commands); });
+
+  calls.release(pass);
+  calls.release(encoder);
+  calls.release(commands);
+  calls.release(fColorAttachment.view);
+  calls.release(surfaceTexture.texture);
+  calls.endFrame();
+}
+
+//------------------------------------------------------------------------
+// Renderer::renderWithoutCache
+// Same rendering, rebuilding all frame resources every frame (kept as a reference for the calls count)
+//------------------------------------------------------------------------
+void Renderer::renderWithoutCache(int iFrame)
+{
+  auto &calls = fUncachedCalls;
+  calls.call([this] { fGPU->pollEvents(); });
 
   wgpu::SurfaceTexture surfaceTexture;
-  fSurface.GetCurrentTexture(&surfaceTexture);
+  calls.call([&] { fSurface.GetCurrentTexture(&surfaceTexture); });
   assert(surfaceTexture.status == wgpu::SurfaceGetCurrentTextureStatus::SuccessOptimal);
-  wgpu::TextureView backbuffer = surfaceTexture.texture.CreateView();
 
   wgpu::RenderPassColorAttachment attachment{};
-  attachment.view = backbuffer;
+  attachment.view = calls.call([&] { return surfaceTexture.texture.CreateView(); });
   attachment.loadOp = wgpu::LoadOp::Clear;
   attachment.storeOp = wgpu::StoreOp::Store;
   attachment.clearValue = {0.5, 0.5, iFrame / 60.0, 1};
@@ -260,57 +663,201 @@ void Renderer::render(int iFrame)
   renderpass.colorAttachments = &attachment;
 
   wgpu::RenderPassDepthStencilAttachment depthStencilAttachment = {};
-  depthStencilAttachment.view = fCanvasDepthStencilView;
+  calls.call([&] { depthStencilAttachment.view = fCanvasDepthStencilView; }); // AddRef
   depthStencilAttachment.depthClearValue = 0;
   depthStencilAttachment.depthLoadOp = wgpu::LoadOp::Clear;
   depthStencilAttachment.depthStoreOp = wgpu::StoreOp::Store;
 
   renderpass.depthStencilAttachment = &depthStencilAttachment;
 
-  wgpu::CommandBuffer commands;
-  {
-    wgpu::CommandEncoder encoder = fGPU->device().CreateCommandEncoder();
-    {
-      wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderpass);
-      pass.SetPipeline(fRenderPipeline);
-      pass.Draw(3);
-      pass.End();
-    }
-    commands = encoder.Finish();
-  }
+  auto encoder = calls.call([this] { return fGPU->device().CreateCommandEncoder(); });
+  auto pass = calls.call([&] { return encoder.BeginRenderPass(&renderpass); });
+  calls.call([&] { pass.SetPipeline(fRenderPipeline); });
+  calls.call([&] { pass.Draw(3); });
+  calls.call([&] { pass.End(); });
+  auto commands = calls.call([&] { return encoder.Finish(); });
+  calls.call([&] { fGPU->queue().Submit(1, &commands); });
+
+  calls.release(pass);
+  calls.release(encoder);
+  calls.release(commands);
+  calls.release(attachment.view);
+  calls.release(depthStencilAttachment.view);
+  calls.release(surfaceTexture.texture);
+  calls.endFrame();
+}
 
-  fGPU->queue().Submit(1, &commands);
+//------------------------------------------------------------------------
+// Renderer::printStats
+//------------------------------------------------------------------------
+void Renderer::printStats() const
+{
+  printf("pipeline cache: %d requests, %d pipelines, %d shader modules\n", fPipelineCache.getRequestCount(),
+         fPipelineCache.getPipelineCount(), fPipelineCache.getShaderModuleCount());
+  printf("wgpu calls per frame: %.1f without cache, %.1f with cache\n", fUncachedCalls.perFrame(),
+         fCachedCalls.perFrame());
+}
+
+EM_JS(int, GetWindowInnerWidth, (), { return window.innerWidth; });
+EM_JS(int, GetWindowInnerHeight, (), { return window.innerHeight; });
+
+//------------------------------------------------------------------------
+// ResizeCoordinator::init
+//------------------------------------------------------------------------
+
+void ResizeCoordinator::init(uint32_t iMaxDimension, OnSizeSettled iOnSizeSettled)
+{
+  fMaxDimension = iMaxDimension;
+  fOnSizeSettled = std::move(iOnSizeSettled);
+  setWindowSize(GetWindowInnerWidth(), GetWindowInnerHeight());
+  fSize = computeSize();
+
+  // the callback only records the new size: nothing is allocated until the size settles (see onSettled)
+  emscripten_set_resize_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, this, false,
+                                 [](int, EmscriptenUiEvent const *iEvent, void *iUserData) -> bool {
+                                   static_cast<ResizeCoordinator *>(iUserData)->onWindowResized(
+                                     iEvent->windowInnerWidth, iEvent->windowInnerHeight);
+                                   return false;
+                                 });
+}
+
+//------------------------------------------------------------------------
+// ResizeCoordinator::setWindowSize
+//------------------------------------------------------------------------
+void ResizeCoordinator::setWindowSize(int iWindowWidth, int iWindowHeight)
+{
+  fCssWidth = iWindowWidth;
+  fCssHeight = iWindowHeight;
+  // a browser zoom changes devicePixelRatio and triggers a resize event
+  fPixelRatio = emscripten_get_device_pixel_ratio();
+  emscripten_set_element_css_size("#canvas", fCssWidth, fCssHeight);
+}
+
+//------------------------------------------------------------------------
+// ResizeCoordinator::onWindowResized
+//------------------------------------------------------------------------
+void ResizeCoordinator::onWindowResized(int iWindowWidth, int iWindowHeight)
+{
+  setWindowSize(iWindowWidth, iWindowHeight);
+  fEventCount++;
+
+  // (re)starts the settle timer
+  if(fSettleTimeout != 0)
+    emscripten_clear_timeout(fSettleTimeout);
+  fSettleTimeout = emscripten_set_timeout([](void *iUserData) {
+    static_cast<ResizeCoordinator *>(iUserData)->onSettled();
+  }, kSettleDelayMs, this);
+}
+
+//------------------------------------------------------------------------
+// ResizeCoordinator::onSettled
+//------------------------------------------------------------------------
+void ResizeCoordinator::onSettled()
+{
+  fSettleTimeout = 0;
+  auto size = computeSize();
+  if(size == fSize)
+    return;
+
+  fSize = size;
+  fResizeCount++;
+  fOnSizeSettled(fSize);
+}
+
+//------------------------------------------------------------------------
+// ResizeCoordinator::computeSize
+//------------------------------------------------------------------------
+ResizeCoordinator::Size ResizeCoordinator::computeSize() const
+{
+  auto ratio = std::min(fPixelRatio, kMaxPixelRatio);
+  auto toPixels = [ratio, this](int iCss) {
+    return std::clamp(static_cast<uint32_t>(std::lround(std::max(iCss, 1) * ratio)), 1u, fMaxDimension);
+  };
+  return {toPixels(fCssWidth), toPixels(fCssHeight)};
 }
 
 static std::unique_ptr<Renderer> kRenderer{};
+static ResizeCoordinator kResizeCoordinator{};
 static int kFrameCount = 0;
+static constexpr int kMaxFrameCount = 60;
+
+// Startup latency: time (in ms) from main() to the device, to the pipelines needed by the first frame and to the
+// first frame
+struct StartupTimes
+{
+  double fStart{};
+  double fDevice{};
+  double fPipelines{};
+  double fFirstFrame{};
+
+  void print() const
+  {
+    printf("startup: device %.1fms, pipelines %.1fms, first frame %.1fms\n", fDevice - fStart, fPipelines - fStart,
+           fFirstFrame - fStart);
+  }
+};
+
+static StartupTimes kStartupTimes{};
 
 //------------------------------------------------------------------------
 // MainLoop
 //------------------------------------------------------------------------
 void MainLoop()
 {
-  if(kFrameCount < 60)
-  {
-    kFrameCount++;
+  kFrameCount++;
+  // first half without the frame resources cache, second half with it, to compare the calls count
+  if(kFrameCount <= kMaxFrameCount / 2)
+    kRenderer->renderWithoutCache(kFrameCount);
+  else
     kRenderer->render(kFrameCount);
+
+  if(kFrameCount == 1)
+  {
+    kStartupTimes.fFirstFrame = emscripten_get_now();
+    kStartupTimes.print();
   }
-  else
+
+  if(kFrameCount == kMaxFrameCount)
   {
-    emscripten_cancel_main_loop();
+    kRenderer->printStats();
     printf("Done \n");
+    // nothing runs anymore until the canvas size changes (see OnSizeSettled)
+    emscripten_cancel_main_loop();
   }
 }
 
+//------------------------------------------------------------------------
+// OnSizeSettled
+//------------------------------------------------------------------------
+void OnSizeSettled(ResizeCoordinator::Size iSize)
+{
+  kRenderer->resize(iSize);
+  printf("resize: %ux%u (%d resize events, %d resizes)\n", iSize.fWidth, iSize.fHeight,
+         kResizeCoordinator.getEventCount(), kResizeCoordinator.getResizeCount());
+  // resizing the canvas clears it: once the main loop is stopped, renders it again (otherwise the next frame does)
+  if(kFrameCount >= kMaxFrameCount)
+    kRenderer->render(kFrameCount);
+}
+
 //------------------------------------------------------------------------
 // main
 //------------------------------------------------------------------------
 int main()
 {
+  kStartupTimes.fStart = emscripten_get_now();
   GPU::asyncCreate([](auto iGPU) {
+                     kStartupTimes.fDevice = emscripten_get_now();
+                     wgpu::Limits limits{};
+                     iGPU->device().GetLimits(&limits);
+                     kResizeCoordinator.init(limits.maxTextureDimension2D, OnSizeSettled);
                      kRenderer = std::make_unique<Renderer>(std::move(iGPU));
-                     kRenderer->init();
-                     emscripten_set_main_loop(MainLoop, 0, true);
+                     kRenderer->asyncInit(kResizeCoordinator.getSize(), [] {
+                       kStartupTimes.fPipelines = emscripten_get_now();
+                       emscripten_set_main_loop(MainLoop, 0, false);
+                     }, [](auto iMessage) {
+                       printf("Error creating the pipelines %.*s\n", static_cast<int>(iMessage.length), iMessage.data);
+                       terminate("Renderer::asyncInit");
+                     });
                    }, [](auto iMessage) {
                      printf("Error creating the GPU %.*s\n", static_cast<int>(iMessage.length), iMessage.data);
                      terminate("GPU::asyncCreate");
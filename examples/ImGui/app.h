@@ -0,0 +1,98 @@
+// Main loop shared by the examples
+//
+// When App::eventDriven is true, the main loop keeps rendering for App::idleFrameCount frames after any activity
+// (input, resize, or explicit call to App::invalidate()) and is then suspended until the next html5 event, so that
+// an idle application does not use any CPU/GPU.
+
+#pragma once
+
+#include <imgui.h>
+#include <emscripten.h>
+#include <emscripten/html5.h>
+#include <functional>
+
+struct App
+{
+  std::function<bool()> renderFrame{};
+  std::function<void()> cleanup{};
+
+  bool eventDriven{false};
+  int idleFrameCount{60};
+
+  // Makes sure that (at least) idleFrameCount more frames are rendered
+  void invalidate()
+  {
+    framesToRender = idleFrameCount;
+    if(suspended)
+    {
+      suspended = false;
+      emscripten_resume_main_loop();
+    }
+  }
+
+  int framesToRender{};
+  bool suspended{false};
+  bool activityListenersInstalled{false};
+};
+
+// Called on any html5 event
+template<typename Event>
+bool App_OnActivity(int, Event const *, void *iUserData)
+{
+  static_cast<App *>(iUserData)->invalidate();
+  return false;
+}
+
+// The listeners are registered with the html5 API (and not from javascript on window/document), so that they also
+// work when the main loop runs in a pthread (-sPROXY_TO_PTHREAD): the events are received on the main thread and the
+// callbacks are called on the thread which registered them. They are registered on the capture phase so that they do
+// not interfere with the GLFW/SDL ones.
+inline void App_InstallActivityListeners(App *iApp)
+{
+  auto const target = EMSCRIPTEN_EVENT_TARGET_WINDOW;
+  emscripten_set_mousemove_callback(target, iApp, true, App_OnActivity<EmscriptenMouseEvent>);
+  emscripten_set_mousedown_callback(target, iApp, true, App_OnActivity<EmscriptenMouseEvent>);
+  emscripten_set_mouseup_callback(target, iApp, true, App_OnActivity<EmscriptenMouseEvent>);
+  emscripten_set_wheel_callback(target, iApp, true, App_OnActivity<EmscriptenWheelEvent>);
+  emscripten_set_keydown_callback(target, iApp, true, App_OnActivity<EmscriptenKeyboardEvent>);
+  emscripten_set_keyup_callback(target, iApp, true, App_OnActivity<EmscriptenKeyboardEvent>);
+  emscripten_set_touchstart_callback(target, iApp, true, App_OnActivity<EmscriptenTouchEvent>);
+  emscripten_set_touchmove_callback(target, iApp, true, App_OnActivity<EmscriptenTouchEvent>);
+  emscripten_set_touchend_callback(target, iApp, true, App_OnActivity<EmscriptenTouchEvent>);
+  emscripten_set_resize_callback(target, iApp, true, App_OnActivity<EmscriptenUiEvent>);
+  emscripten_set_focus_callback(target, iApp, true, App_OnActivity<EmscriptenFocusEvent>);
+  emscripten_set_blur_callback(target, iApp, true, App_OnActivity<EmscriptenFocusEvent>);
+  emscripten_set_visibilitychange_callback(iApp, true, App_OnActivity<EmscriptenVisibilityChangeEvent>);
+}
+
+static void MainLoopForEmscripten(void *iUserData)
+{
+  auto app = reinterpret_cast<App *>(iUserData);
+  if(app->renderFrame())
+  {
+    if(app->cleanup)
+      app->cleanup();
+    emscripten_cancel_main_loop();
+    return;
+  }
+
+  if(!app->eventDriven)
+    return;
+
+  if(!app->activityListenersInstalled)
+  {
+    app->activityListenersInstalled = true;
+    App_InstallActivityListeners(app);
+    app->invalidate();
+  }
+
+  // a text input cursor is blinking
+  if(ImGui::GetCurrentContext() && ImGui::GetIO().WantTextInput)
+    app->framesToRender = app->idleFrameCount;
+
+  if(--app->framesToRender <= 0)
+  {
+    app->suspended = true;
+    emscripten_pause_main_loop();
+  }
+}
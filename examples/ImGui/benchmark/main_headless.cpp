@@ -0,0 +1,348 @@
+// Dear ImGui: headless benchmark measuring the CPU cost of ImGui (NewFrame/UI/Render) with synthetic workloads
+// - no platform backend and a null renderer (the port is used with backend=none:renderer=none)
+// - runs in node (no browser, canvas or GPU required)
+//
+// Usage: node bench.js [frames] [workload...]
+// Each result is printed as a line starting with "BENCH " followed by json (see run_benchmarks.py). Besides the
+// average, each frame is timed to report the worst one (max_ns_per_frame), and the largest texture update requested
+// by ImGui during a frame (max_texture_bytes).
+
+#include <imgui.h>
+#include <emscripten/version.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------
+// Allocations tracking (ImGui allocations only)
+//------------------------------------------------------------------------
+static int64_t kAllocationCount = 0;
+
+static void *CountingAlloc(size_t iSize, void *)
+{
+  kAllocationCount++;
+  return malloc(iSize);
+}
+
+static void CountingFree(void *iPtr, void *)
+{
+  free(iPtr);
+}
+
+//------------------------------------------------------------------------
+// Null renderer: acknowledges texture requests (ImGuiBackendFlags_RendererHasTextures) without uploading anything
+// (returns the number of bytes a renderer would upload)
+//------------------------------------------------------------------------
+static size_t NullRenderer_UpdateTextures(ImDrawData *iDrawData)
+{
+  static intptr_t kNextTextureID = 1;
+
+  size_t bytes = 0;
+  if(!iDrawData->Textures)
+    return bytes;
+
+  for(ImTextureData *tex: *iDrawData->Textures)
+  {
+    switch(tex->Status)
+    {
+      case ImTextureStatus_WantCreate:
+        tex->SetTexID(static_cast<ImTextureID>(kNextTextureID++));
+        tex->SetStatus(ImTextureStatus_OK);
+        bytes += static_cast<size_t>(tex->GetSizeInBytes());
+        break;
+      case ImTextureStatus_WantUpdates:
+        tex->SetStatus(ImTextureStatus_OK);
+        bytes += static_cast<size_t>(tex->UpdateRect.w) * tex->UpdateRect.h * tex->BytesPerPixel;
+        break;
+      case ImTextureStatus_WantDestroy:
+        tex->SetTexID(ImTextureID_Invalid);
+        tex->SetStatus(ImTextureStatus_Destroyed);
+        break;
+      default:
+        break;
+    }
+  }
+  return bytes;
+}
+
+//------------------------------------------------------------------------
+// Workloads
+//------------------------------------------------------------------------
+static void FullScreenWindow()
+{
+  auto viewport = ImGui::GetMainViewport();
+  ImGui::SetNextWindowPos(viewport->WorkPos);
+  ImGui::SetNextWindowSize(viewport->WorkSize);
+}
+
+#ifndef IMGUI_DISABLE_DEMO
+static void Workload_Demo()
+{
+  ImGui::ShowDemoWindow();
+}
+#endif
+
+static void Workload_Table(bool iUseClipper)
+{
+  static constexpr int kRowCount = 10000;
+  FullScreenWindow();
+  ImGui::Begin("Table");
+  auto flags = ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable;
+  if(ImGui::BeginTable("table", 4, flags))
+  {
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("ID");
+    ImGui::TableSetupColumn("Name");
+    ImGui::TableSetupColumn("Value");
+    ImGui::TableSetupColumn("Progress");
+    ImGui::TableHeadersRow();
+
+    auto row = [](int i) {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::Text("%04d", i);
+      ImGui::TableNextColumn();
+      ImGui::Text("Item %d", i);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", std::sin(static_cast<float>(i)));
+      ImGui::TableNextColumn();
+      ImGui::ProgressBar(static_cast<float>(i % 100) / 100.0f, ImVec2(-1.0f, 0.0f));
+    };
+
+    if(iUseClipper)
+    {
+      ImGuiListClipper clipper;
+      clipper.Begin(kRowCount);
+      while(clipper.Step())
+      {
+        for(int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+          row(i);
+      }
+    }
+    else
+    {
+      for(int i = 0; i < kRowCount; i++)
+        row(i);
+    }
+    ImGui::EndTable();
+  }
+  ImGui::End();
+}
+
+static void Workload_LargeText()
+{
+  static std::string kText = [] {
+    std::string text;
+    for(int i = 0; i < 20000; i++)
+      text += "Line " + std::to_string(i) + ": Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod.\n";
+    return text;
+  }();
+
+  FullScreenWindow();
+  ImGui::Begin("Large text");
+  if(ImGui::BeginChild("unformatted", ImVec2(0.0f, ImGui::GetContentRegionAvail().y * 0.5f)))
+    ImGui::TextUnformatted(kText.c_str(), kText.c_str() + kText.size());
+  ImGui::EndChild();
+  if(ImGui::BeginChild("wrapped"))
+  {
+    for(int i = 0; i < 200; i++)
+      ImGui::TextWrapped("%d. The quick brown fox jumps over the lazy dog. Pack my box with five dozen liquor jugs. "
+                         "How vexingly quick daft zebras jump! Sphinx of black quartz, judge my vow.", i);
+  }
+  ImGui::EndChild();
+  ImGui::End();
+}
+
+static void Workload_DensePlots()
+{
+  static constexpr int kPlotCount = 8;
+  static constexpr int kValueCount = 10000;
+  static constexpr int kPointCount = 100000;
+  static std::vector<float> kValues = [] {
+    std::vector<float> values(kValueCount);
+    for(int i = 0; i < kValueCount; i++)
+      values[i] = std::sin(static_cast<float>(i) * 0.01f) + std::sin(static_cast<float>(i) * 0.37f) * 0.2f;
+    return values;
+  }();
+  static std::vector<ImVec2> kPoints(kPointCount);
+
+  FullScreenWindow();
+  ImGui::Begin("Dense plots");
+  for(int i = 0; i < kPlotCount; i++)
+  {
+    ImGui::PushID(i);
+    ImGui::PlotLines("##lines", kValues.data(), kValueCount, i * 100, nullptr, -1.5f, 1.5f, ImVec2(-1.0f, 60.0f));
+    ImGui::PopID();
+  }
+
+  auto min = ImGui::GetCursorScreenPos();
+  auto size = ImGui::GetContentRegionAvail();
+  for(int i = 0; i < kPointCount; i++)
+  {
+    auto x = static_cast<float>(i) / static_cast<float>(kPointCount - 1);
+    kPoints[i] = ImVec2(min.x + x * size.x, min.y + size.y * (0.5f + 0.4f * kValues[i % kValueCount]));
+  }
+  // split in chunks to stay below 64k vertices per draw command with 16-bit indices
+  auto drawList = ImGui::GetWindowDrawList();
+  for(int i = 0; i < kPointCount - 1; i += 8192)
+    drawList->AddPolyline(kPoints.data() + i, std::min(8193, kPointCount - i), IM_COL32(255, 200, 0, 255),
+                          ImDrawFlags_None, 1.0f);
+  ImGui::End();
+}
+
+// Renders the Latin-1 characters at 4 font sizes never used before every 30 frames: each burst rasterizes ~760 glyphs
+// in a single frame (the frames in between are cheap), which shows in max_ns_per_frame rather than in the average
+static void Workload_GlyphBurst()
+{
+  static constexpr int kBurstPeriod = 30;
+  static constexpr int kSizesPerBurst = 4;
+  static std::string const kText = [] {
+    std::string text;
+    for(unsigned int c = 0x20; c <= 0xFF; c++)
+    {
+      if(c >= 0x7F && c < 0xA0)
+        continue;
+      if(c < 0x80)
+        text += static_cast<char>(c);
+      else
+      {
+        text += static_cast<char>(0xC0 | (c >> 6));
+        text += static_cast<char>(0x80 | (c & 0x3F));
+      }
+    }
+    return text;
+  }();
+  static int kFrame = 0;
+  static float kFirstSize = 20.0f;
+
+  if(kFrame++ % kBurstPeriod == 0)
+    kFirstSize += kSizesPerBurst;
+
+  FullScreenWindow();
+  ImGui::Begin("Glyph burst");
+  for(int i = 0; i < kSizesPerBurst; i++)
+  {
+    ImGui::PushFont(nullptr, kFirstSize + static_cast<float>(i));
+    ImGui::TextWrapped("%s", kText.c_str());
+    ImGui::PopFont();
+  }
+  ImGui::End();
+}
+
+struct Workload
+{
+  char const *fName;
+  void (*fFunction)();
+};
+
+static Workload const kWorkloads[] = {
+#ifndef IMGUI_DISABLE_DEMO
+  {"demo", Workload_Demo},
+#endif
+  {"table_10k", [] { Workload_Table(false); }},
+  {"table_10k_clipped", [] { Workload_Table(true); }},
+  {"large_text", Workload_LargeText},
+  {"dense_plots", Workload_DensePlots},
+  {"glyph_burst", Workload_GlyphBurst},
+};
+
+//------------------------------------------------------------------------
+// Benchmark
+//------------------------------------------------------------------------
+struct FrameResult
+{
+  int fVertexCount{};
+  int fIndexCount{};
+  int fDrawCmdCount{};
+  size_t fTextureBytes{};
+};
+
+static FrameResult RenderFrame(Workload const &iWorkload, int iFrame)
+{
+  auto &io = ImGui::GetIO();
+  io.DeltaTime = 1.0f / 60.0f;
+  // moves the mouse around to trigger hovering
+  io.AddMousePosEvent(io.DisplaySize.x * (0.5f + 0.4f * std::sin(static_cast<float>(iFrame) * 0.05f)),
+                      io.DisplaySize.y * (0.5f + 0.4f * std::cos(static_cast<float>(iFrame) * 0.03f)));
+
+  ImGui::NewFrame();
+  iWorkload.fFunction();
+  ImGui::Render();
+
+  auto drawData = ImGui::GetDrawData();
+  auto textureBytes = NullRenderer_UpdateTextures(drawData);
+
+  FrameResult res{drawData->TotalVtxCount, drawData->TotalIdxCount, 0, textureBytes};
+  for(auto list: drawData->CmdLists)
+    res.fDrawCmdCount += list->CmdBuffer.Size;
+  return res;
+}
+
+static void RunWorkload(Workload const &iWorkload, int iFrameCount)
+{
+  ImGui::SetAllocatorFunctions(CountingAlloc, CountingFree);
+  ImGui::CreateContext();
+  auto &io = ImGui::GetIO();
+  io.IniFilename = nullptr;
+  io.DisplaySize = ImVec2(1920.0f, 1080.0f);
+  io.BackendRendererName = "null";
+  io.BackendFlags |= ImGuiBackendFlags_RendererHasTextures | ImGuiBackendFlags_RendererHasVtxOffset;
+#ifdef IMGUI_ENABLE_DOCKING
+  io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
+#endif
+
+  // warm up (font atlas, windows creation, ...)
+  for(int i = 0; i < 60; i++)
+    RenderFrame(iWorkload, i);
+
+  FrameResult res{};
+  kAllocationCount = 0;
+  int64_t ns = 0;
+  int64_t maxNs = 0;
+  size_t maxTextureBytes = 0;
+  for(int i = 0; i < iFrameCount; i++)
+  {
+    auto start = std::chrono::steady_clock::now();
+    res = RenderFrame(iWorkload, i);
+    auto end = std::chrono::steady_clock::now();
+    auto frameNs = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    ns += frameNs;
+    maxNs = std::max<int64_t>(maxNs, frameNs);
+    maxTextureBytes = std::max(maxTextureBytes, res.fTextureBytes);
+  }
+
+  printf("BENCH {\"workload\":\"%s\",\"frames\":%d,\"ns_per_frame\":%lld,\"max_ns_per_frame\":%lld,"
+         "\"allocs_per_frame\":%.2f,\"vertices\":%d,\"indices\":%d,\"draw_cmds\":%d,\"upload_bytes\":%zu,"
+         "\"max_texture_bytes\":%zu}\n",
+         iWorkload.fName, iFrameCount, static_cast<long long>(ns / iFrameCount), static_cast<long long>(maxNs),
+         static_cast<double>(kAllocationCount) / iFrameCount, res.fVertexCount, res.fIndexCount, res.fDrawCmdCount,
+         res.fVertexCount * sizeof(ImDrawVert) + res.fIndexCount * sizeof(ImDrawIdx), maxTextureBytes);
+
+  ImGui::DestroyContext();
+}
+
+int main(int argc, char **argv)
+{
+  int frameCount = argc > 1 ? atoi(argv[1]) : 300;
+
+  printf("Emscripten: %d.%d.%d\n", __EMSCRIPTEN_MAJOR__, __EMSCRIPTEN_MINOR__, __EMSCRIPTEN_TINY__);
+  printf("ImGui: %s\n", IMGUI_VERSION);
+  printf("sizeof(ImDrawVert): %zu, sizeof(ImDrawIdx): %zu\n", sizeof(ImDrawVert), sizeof(ImDrawIdx));
+
+  for(auto const &workload: kWorkloads)
+  {
+    bool selected = argc <= 2;
+    for(int i = 2; i < argc; i++)
+      selected |= strcmp(argv[i], workload.fName) == 0;
+    if(selected)
+      RunWorkload(workload, frameCount);
+  }
+
+  return 0;
+}
@@ -0,0 +1,106 @@
+# Builds the headless benchmark for each combination of port options and runs it with node
+#
+# Usage: python3 run_benchmarks.py [options] [-- extra emcc flags]
+#   --frames N                 number of measured frames per workload (default to 300)
+#   --workloads w1,w2          workloads to run (default to all)
+#   --optimizationLevel 2,3,s  values to test (default to all)
+#   --branch master,docking    values to test (default to all)
+#   --disableDemo false,true   values to test (default to all)
+#   --port-options a=b:c=d     additional port options applied to every build (ex: unity=true:drawIdx=32)
+#   --build-dir DIR            where the benchmarks are built (default to /tmp/imgui-benchmark)
+#   --json FILE                also writes all the results in FILE
+#
+# Each build links the ImGui core only (backend=none:renderer=none) and the library is built with the same
+# optimization level as the benchmark itself. KB/frame is the size of the geometry a renderer would upload each
+# frame (compare with --port-options drawIdx=32 or compactVertex=true). max us is the worst frame (see the glyph_burst
+# workload) and tex KB the largest texture update requested by ImGui in a single frame.
+
+import argparse
+import itertools
+import json
+import os
+import subprocess
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+PORT = os.path.abspath(os.path.join(HERE, '..', '..', '..', 'ports', 'ImGui', 'imgui.py'))
+
+OPTIMIZATION_LEVELS = ['0', '1', '2', '3', 'g', 's', 'z']
+BRANCHES = ['master', 'docking']
+DISABLE_DEMO = ['false', 'true']
+
+
+def csv(value):
+    return [v for v in value.split(',') if v]
+
+
+def build(variant, args, extra_flags):
+    name = f'bench-O{variant["optimizationLevel"]}-{variant["branch"]}{"-nodemo" if variant["disableDemo"] == "true" else ""}'
+    output = os.path.join(args.build_dir, f'{name}.js')
+    port_options = ':'.join([
+        'backend=none', 'renderer=none',
+        f'branch={variant["branch"]}',
+        f'disableDemo={variant["disableDemo"]}',
+        f'optimizationLevel={variant["optimizationLevel"]}'
+    ] + ([args.port_options] if args.port_options else []))
+    command = ['emcc', f'-O{variant["optimizationLevel"]}', '-sALLOW_MEMORY_GROWTH=1', '-sENVIRONMENT=node',
+               f'--use-port={PORT}:{port_options}'] + extra_flags + \
+              [os.path.join(HERE, 'main_headless.cpp'), '-o', output]
+    print(' '.join(command), flush=True)
+    subprocess.run(command, check=True)
+    return output
+
+
+def run(output, args):
+    command = ['node', output, str(args.frames)] + args.workloads
+    res = subprocess.run(command, check=True, capture_output=True, text=True)
+    return [json.loads(line[len('BENCH '):]) for line in res.stdout.splitlines() if line.startswith('BENCH ')]
+
+
+def main():
+    argv = sys.argv[1:]
+    extra_flags = []
+    if '--' in argv:
+        extra_flags = argv[argv.index('--') + 1:]
+        argv = argv[:argv.index('--')]
+
+    parser = argparse.ArgumentParser(description='Runs the ImGui headless benchmark for each library variant')
+    parser.add_argument('--frames', type=int, default=300)
+    parser.add_argument('--workloads', type=csv, default=[])
+    parser.add_argument('--optimizationLevel', type=csv, default=OPTIMIZATION_LEVELS)
+    parser.add_argument('--branch', type=csv, default=BRANCHES)
+    parser.add_argument('--disableDemo', type=csv, default=DISABLE_DEMO)
+    parser.add_argument('--port-options', default='')
+    parser.add_argument('--build-dir', default='/tmp/imgui-benchmark')
+    parser.add_argument('--json')
+    args = parser.parse_args(argv)
+
+    os.makedirs(args.build_dir, exist_ok=True)
+
+    results = []
+    for optimization_level, branch, disable_demo in itertools.product(args.optimizationLevel, args.branch,
+                                                                      args.disableDemo):
+        variant = {'optimizationLevel': optimization_level, 'branch': branch, 'disableDemo': disable_demo}
+        output = build(variant, args, extra_flags)
+        for result in run(output, args):
+            results.append({**variant, **result})
+
+    # summary (fastest first for each workload)
+    workloads = sorted({r['workload'] for r in results})
+    for workload in workloads:
+        print(f'\n{workload}')
+        print(f'  {"variant":<28} {"us/frame":>10} {"max us":>10} {"allocs/frame":>13} {"vertices":>9} '
+              f'{"indices":>9} {"KB/frame":>9} {"tex KB":>9}')
+        for r in sorted([r for r in results if r['workload'] == workload], key=lambda r: r['ns_per_frame']):
+            variant = f'-O{r["optimizationLevel"]} {r["branch"]} disableDemo={r["disableDemo"]}'
+            print(f'  {variant:<28} {r["ns_per_frame"] / 1000:>10.1f} {r["max_ns_per_frame"] / 1000:>10.1f} '
+                  f'{r["allocs_per_frame"]:>13.2f} {r["vertices"]:>9} {r["indices"]:>9} '
+                  f'{r["upload_bytes"] / 1024:>9.1f} {r["max_texture_bytes"] / 1024:>9.1f}')
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump(results, f, indent=2)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,237 @@
+// Frame time instrumentation shared by the examples
+//
+// - times each phase of a frame (call beginFrame(), then mark() at the end of each phase, then endFrame())
+// - records the vertex/index/draw command counts of the ImDrawData and the size of the geometry to upload
+// - keeps the last kSampleCount samples of each series in a lock-free ring buffer
+// - renderOverlay() shows the p50/p95/p99/max of each series in an ImGui window (the max shows the worst frame, for
+//   example during a burst of new glyphs)
+// - the same statistics are available as json from javascript: Module.getFrameStats()
+
+#pragma once
+
+#include <imgui.h>
+#include <emscripten.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <string>
+
+EM_JS_DEPS(frame_stats, "$UTF8ToString");
+
+// Runs on the main thread, even when the frames are rendered by a pthread (-sPROXY_TO_PTHREAD), so that
+// Module.getFrameStats() is available from the page
+inline void FrameStats_InstallJSAccessor()
+{
+  MAIN_THREAD_EM_ASM({
+    Module['getFrameStats'] = () => JSON.parse(UTF8ToString(_FrameStats_GetJson()));
+  });
+}
+
+enum class FramePhase
+{
+  PollEvents,
+  NewFrame,
+  BuildUI,
+  Render,
+  RenderDrawData,
+  Submit,
+  Count
+};
+
+// Single producer ring buffer: a reader can take a snapshot at any time without locking the producer
+template<int N>
+class SampleRing
+{
+public:
+  void push(float iSample)
+  {
+    auto index = fWriteIndex.load(std::memory_order_relaxed);
+    fSamples[index % N].store(iSample, std::memory_order_relaxed);
+    fWriteIndex.store(index + 1, std::memory_order_release);
+  }
+
+  // copies the available samples in oSamples and returns how many were copied
+  int snapshot(std::array<float, N> &oSamples) const
+  {
+    auto count = static_cast<int>(std::min<unsigned int>(fWriteIndex.load(std::memory_order_acquire), N));
+    for(int i = 0; i < count; i++)
+      oSamples[i] = fSamples[i].load(std::memory_order_relaxed);
+    return count;
+  }
+
+  float last() const
+  {
+    auto index = fWriteIndex.load(std::memory_order_acquire);
+    return index == 0 ? 0.0f : fSamples[(index - 1) % N].load(std::memory_order_relaxed);
+  }
+
+private:
+  std::array<std::atomic<float>, N> fSamples{};
+  std::atomic<unsigned int> fWriteIndex{0};
+};
+
+class FrameStats
+{
+public:
+  static constexpr int kSampleCount = 512;
+
+  enum Series
+  {
+    kPhaseSeries = 0, // one per FramePhase
+    kFrameSeries = static_cast<int>(FramePhase::Count),
+    kInputLatencySeries, // only pushed by the frames processing input (see input_coalescer.h)
+    kVertexSeries,
+    kIndexSeries,
+    kDrawCmdSeries,
+    kUploadBytesSeries,
+    kSeriesCount
+  };
+
+  struct Percentiles
+  {
+    float fLast{};
+    float fP50{};
+    float fP95{};
+    float fP99{};
+    float fMax{};
+  };
+
+  void beginFrame()
+  {
+    if(!fJSAccessorInstalled)
+    {
+      fJSAccessorInstalled = true;
+      FrameStats_InstallJSAccessor();
+    }
+    fFrameStart = fPhaseStart = emscripten_get_now();
+  }
+
+  // marks the end of the phase (which started at the end of the previous phase)
+  void mark(FramePhase iPhase)
+  {
+    auto now = emscripten_get_now();
+    fSeries[static_cast<int>(iPhase)].push(static_cast<float>(now - fPhaseStart));
+    fPhaseStart = now;
+  }
+
+  void endFrame(ImDrawData const *iDrawData)
+  {
+    fSeries[kFrameSeries].push(static_cast<float>(emscripten_get_now() - fFrameStart));
+    int drawCmdCount = 0;
+    if(iDrawData)
+    {
+      for(auto list: iDrawData->CmdLists)
+        drawCmdCount += list->CmdBuffer.Size;
+    }
+    fSeries[kVertexSeries].push(iDrawData ? static_cast<float>(iDrawData->TotalVtxCount) : 0.0f);
+    fSeries[kIndexSeries].push(iDrawData ? static_cast<float>(iDrawData->TotalIdxCount) : 0.0f);
+    fSeries[kDrawCmdSeries].push(static_cast<float>(drawCmdCount));
+    // depends on the drawIdx/compactVertex port options
+    fSeries[kUploadBytesSeries].push(iDrawData ? static_cast<float>(iDrawData->TotalVtxCount * sizeof(ImDrawVert) +
+                                                                    iDrawData->TotalIdxCount * sizeof(ImDrawIdx)) : 0.0f);
+  }
+
+  // time from the oldest input event to the submission of the frame which processed it
+  void recordInputLatency(float iMs)
+  {
+    fSeries[kInputLatencySeries].push(iMs);
+  }
+
+  Percentiles computePercentiles(int iSeries) const
+  {
+    std::array<float, kSampleCount> samples;
+    auto count = fSeries[iSeries].snapshot(samples);
+    Percentiles res{};
+    res.fLast = fSeries[iSeries].last();
+    if(count > 0)
+    {
+      std::sort(samples.begin(), samples.begin() + count);
+      auto at = [&samples, count](float p) { return samples[std::min(count - 1, static_cast<int>(p * count))]; };
+      res.fP50 = at(0.50f);
+      res.fP95 = at(0.95f);
+      res.fP99 = at(0.99f);
+      res.fMax = samples[count - 1];
+    }
+    return res;
+  }
+
+  static char const *getSeriesName(int iSeries)
+  {
+    static constexpr char const *kNames[kSeriesCount] = {
+      "poll_events", "new_frame", "build_ui", "render", "render_draw_data", "submit", "frame",
+      "input_latency", "vertices", "indices", "draw_cmds", "upload_bytes"
+    };
+    return kNames[iSeries];
+  }
+
+  void renderOverlay(bool *iOpen)
+  {
+    auto viewport = ImGui::GetMainViewport();
+    ImGui::SetNextWindowPos(ImVec2(viewport->WorkPos.x + viewport->WorkSize.x - 10.0f, viewport->WorkPos.y + 10.0f),
+                            ImGuiCond_Always, ImVec2(1.0f, 0.0f));
+    ImGui::SetNextWindowBgAlpha(0.75f);
+    auto flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings |
+                 ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav;
+    if(ImGui::Begin("Frame stats", iOpen, flags))
+    {
+      if(ImGui::BeginTable("stats", 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit))
+      {
+        ImGui::TableSetupColumn("");
+        ImGui::TableSetupColumn("last");
+        ImGui::TableSetupColumn("p50");
+        ImGui::TableSetupColumn("p95");
+        ImGui::TableSetupColumn("p99");
+        ImGui::TableSetupColumn("max");
+        ImGui::TableHeadersRow();
+        for(int series = 0; series < kSeriesCount; series++)
+        {
+          auto p = computePercentiles(series);
+          auto format = series <= kInputLatencySeries ? "%.3f" : "%.0f";
+          ImGui::TableNextRow();
+          ImGui::TableNextColumn();
+          ImGui::TextUnformatted(getSeriesName(series));
+          for(auto value: {p.fLast, p.fP50, p.fP95, p.fP99, p.fMax})
+          {
+            ImGui::TableNextColumn();
+            ImGui::Text(format, value);
+          }
+        }
+        ImGui::EndTable();
+      }
+      ImGui::TextDisabled("(times in ms, last %d frames)", kSampleCount);
+    }
+    ImGui::End();
+  }
+
+  std::string toJson() const
+  {
+    std::string json = "{";
+    char buffer[128];
+    for(int series = 0; series < kSeriesCount; series++)
+    {
+      auto p = computePercentiles(series);
+      snprintf(buffer, sizeof(buffer), "%s\"%s\":{\"last\":%g,\"p50\":%g,\"p95\":%g,\"p99\":%g,\"max\":%g}",
+               series == 0 ? "" : ",", getSeriesName(series), p.fLast, p.fP50, p.fP95, p.fP99, p.fMax);
+      json += buffer;
+    }
+    json += "}";
+    return json;
+  }
+
+private:
+  std::array<SampleRing<kSampleCount>, kSeriesCount> fSeries{};
+  double fFrameStart{};
+  double fPhaseStart{};
+  bool fJSAccessorInstalled{};
+};
+
+inline FrameStats gFrameStats{};
+
+// Called from javascript (Module.getFrameStats())
+extern "C" EMSCRIPTEN_KEEPALIVE inline char const *FrameStats_GetJson()
+{
+  static std::string json{};
+  json = gFrameStats.toJson();
+  return json.c_str();
+}
@@ -0,0 +1,94 @@
+// Glyph burst stress test (see main_glfw_opengl3_diagnostics.cpp)
+//
+// Each burst renders the Latin-1 characters (0x20-0xFF) at fSizesPerBurst font sizes never used before, so that ImGui
+// rasterizes all their glyphs during the same frame (like a zoom, or text in a new language): the font atlas texture
+// gets hundreds of updates at once. Compare the "frame" max of the frame stats with and without an upload budget
+// (renderer=webgl2 / wgpu-ring, see imgui_texture_uploads.h).
+
+#pragma once
+
+#include <imgui.h>
+#include <string>
+
+struct GlyphBurst
+{
+  int fSizesPerBurst{4};
+
+  // "Glyph burst" button and settings, to add to a window
+  void renderControls()
+  {
+    if(ImGui::Button("Glyph burst"))
+      trigger();
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 6.0f);
+    ImGui::SliderInt("sizes per burst", &fSizesPerBurst, 1, 16);
+  }
+
+  void trigger()
+  {
+    fFirstSize = fNextSize;
+    fNextSize += static_cast<float>(fSizesPerBurst);
+    fSizeCount = fSizesPerBurst;
+    fGlyphs = fSizesPerBurst * kGlyphCount;
+    fBursts++;
+  }
+
+  int getBurstCount() const { return fBursts; }
+  int getGlyphCount() const { return fGlyphs; } // number of glyphs requested by the last burst
+
+  // Shows the text of the last burst (the glyphs are only rasterized once, during the frame of the burst)
+  void renderWindow()
+  {
+    if(fSizeCount == 0)
+      return;
+    bool open = true;
+    ImGui::SetNextWindowSize(ImVec2(600.0f, 400.0f), ImGuiCond_FirstUseEver);
+    if(ImGui::Begin("Glyph burst", &open))
+    {
+      ImGui::Text("Burst #%d: %d glyphs at sizes %.0f to %.0f", fBursts, fGlyphs, fFirstSize,
+                  fFirstSize + static_cast<float>(fSizeCount - 1));
+      for(int i = 0; i < fSizeCount; i++)
+      {
+        ImGui::PushFont(nullptr, fFirstSize + static_cast<float>(i));
+        ImGui::TextWrapped("%s", getText().c_str());
+        ImGui::PopFont();
+      }
+    }
+    ImGui::End();
+    if(!open)
+      fSizeCount = 0;
+  }
+
+private:
+  // 0x20-0x7E and 0xA0-0xFF
+  static constexpr int kGlyphCount = 95 + 96;
+
+  // the printable Latin-1 characters (UTF-8 encoded)
+  static std::string const &getText()
+  {
+    static std::string const kText = []() {
+      std::string text{};
+      for(unsigned int c = 0x20; c <= 0xFF; c++)
+      {
+        if(c >= 0x7F && c < 0xA0)
+          continue;
+        if(c < 0x80)
+          text += static_cast<char>(c);
+        else
+        {
+          text += static_cast<char>(0xC0 | (c >> 6));
+          text += static_cast<char>(0x80 | (c & 0x3F));
+        }
+      }
+      return text;
+    }();
+    return kText;
+  }
+
+  // sizes are never reused: every burst rasterizes new glyphs
+  float fNextSize{20.0f};
+  float fFirstSize{};
+  int fSizeCount{};
+  int fBursts{};
+  int fGlyphs{};
+};
@@ -0,0 +1,244 @@
+// Minimal ImGui platform layer on top of the emscripten html5 API
+//
+// Used instead of the GLFW/SDL backends when the application creates its own WebGL context, for example to render
+// in a pthread (main_html5_opengl3_worker.cpp). The html5 callbacks are registered from the thread calling init():
+// when it is not the main browser thread, the DOM events are captured on the main thread and forwarded to it
+// (EM_CALLBACK_THREAD_CONTEXT_CALLING_THREAD), and processed when it returns to its event loop (between frames).
+// Since the events are handled after the fact, the callbacks cannot prevent the default browser actions (see
+// preventDefaultKeyActions in shell.html).
+//
+// The canvas is expected to fill the window (see shell.html): its size follows the window resize events, and its
+// size in pixels is only changed once the size has settled (see SurfaceResizer).
+
+#pragma once
+
+#include <imgui.h>
+#include <emscripten.h>
+#include <emscripten/html5.h>
+#include <cfloat>
+#include <cstdlib>
+#include <cstring>
+#include "surface_resizer.h"
+
+class Html5Platform
+{
+public:
+  // iCanvasSelector must remain valid (ex: a string literal)
+  void init(char const *iCanvasSelector)
+  {
+    fCanvasSelector = iCanvasSelector;
+
+    double w, h;
+    emscripten_get_element_css_size(fCanvasSelector, &w, &h);
+    fCssWidth = static_cast<int>(w);
+    fCssHeight = static_cast<int>(h);
+    fPixelRatio = static_cast<float>(emscripten_get_device_pixel_ratio());
+
+    ImGuiIO &io = ImGui::GetIO();
+    io.BackendPlatformName = "html5_platform";
+    io.BackendPlatformUserData = this;
+
+    emscripten_set_mousemove_callback(fCanvasSelector, this, true, onMouseMove);
+    emscripten_set_mousedown_callback(fCanvasSelector, this, true, onMouseButton);
+    emscripten_set_mouseup_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, this, true, onMouseButton);
+    emscripten_set_mouseleave_callback(fCanvasSelector, this, true, onMouseLeave);
+    emscripten_set_wheel_callback(fCanvasSelector, this, true, onWheel);
+    emscripten_set_keydown_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, this, true, onKey);
+    emscripten_set_keyup_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, this, true, onKey);
+    emscripten_set_focus_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, this, true, onFocus);
+    emscripten_set_blur_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, this, true, onFocus);
+    emscripten_set_resize_callback(EMSCRIPTEN_EVENT_TARGET_WINDOW, this, false, onResize);
+  }
+
+  void shutdown()
+  {
+    emscripten_html5_remove_all_event_listeners();
+    ImGuiIO &io = ImGui::GetIO();
+    io.BackendPlatformName = nullptr;
+    io.BackendPlatformUserData = nullptr;
+  }
+
+  // Updates the display size/scale and the delta time, and resizes the canvas once its size has settled
+  void newFrame()
+  {
+    ImGuiIO &io = ImGui::GetIO();
+
+    if(fResizer.update(fCssWidth, fCssHeight, fPixelRatio, emscripten_get_now()))
+      emscripten_set_canvas_element_size(fCanvasSelector, fResizer.width, fResizer.height);
+
+    // while a resize is pending, the canvas keeps its size in pixels (stretched by the browser)
+    io.DisplaySize = ImVec2(static_cast<float>(fCssWidth), static_cast<float>(fCssHeight));
+    if(fResizer.configurations > 0 && fCssWidth > 0 && fCssHeight > 0)
+      io.DisplayFramebufferScale = ImVec2(static_cast<float>(fResizer.width) / fCssWidth,
+                                          static_cast<float>(fResizer.height) / fCssHeight);
+
+    auto now = emscripten_get_now();
+    io.DeltaTime = fTime > 0 ? static_cast<float>((now - fTime) / 1000.0) : 1.0f / 60.0f;
+    if(io.DeltaTime <= 0)
+      io.DeltaTime = 1.0f / 1000.0f;
+    fTime = now;
+  }
+
+  // Size of the canvas in pixels
+  int getFramebufferWidth() const { return fResizer.width; }
+  int getFramebufferHeight() const { return fResizer.height; }
+  SurfaceResizer const &getResizer() const { return fResizer; }
+
+  // Number of DOM events received (forwarded from the main thread when running in a pthread)
+  int getEventCount() const { return fEventCount; }
+
+private:
+  static Html5Platform &from(void *iUserData) { return *static_cast<Html5Platform *>(iUserData); }
+
+  static void addModifiers(bool iCtrl, bool iShift, bool iAlt, bool iMeta)
+  {
+    ImGuiIO &io = ImGui::GetIO();
+    io.AddKeyEvent(ImGuiMod_Ctrl, iCtrl);
+    io.AddKeyEvent(ImGuiMod_Shift, iShift);
+    io.AddKeyEvent(ImGuiMod_Alt, iAlt);
+    io.AddKeyEvent(ImGuiMod_Super, iMeta);
+  }
+
+  static bool onMouseMove(int, EmscriptenMouseEvent const *iEvent, void *iUserData)
+  {
+    from(iUserData).fEventCount++;
+    ImGui::GetIO().AddMousePosEvent(static_cast<float>(iEvent->targetX), static_cast<float>(iEvent->targetY));
+    return false;
+  }
+
+  static bool onMouseButton(int iEventType, EmscriptenMouseEvent const *iEvent, void *iUserData)
+  {
+    from(iUserData).fEventCount++;
+    // DOM: 0 = left, 1 = middle, 2 = right / ImGui: 0 = left, 1 = right, 2 = middle
+    static constexpr int kButtons[] = {0, 2, 1, 3, 4};
+    if(iEvent->button >= IM_ARRAYSIZE(kButtons))
+      return false;
+    addModifiers(iEvent->ctrlKey, iEvent->shiftKey, iEvent->altKey, iEvent->metaKey);
+    ImGui::GetIO().AddMouseButtonEvent(kButtons[iEvent->button], iEventType == EMSCRIPTEN_EVENT_MOUSEDOWN);
+    return false;
+  }
+
+  static bool onMouseLeave(int, EmscriptenMouseEvent const *, void *iUserData)
+  {
+    from(iUserData).fEventCount++;
+    ImGui::GetIO().AddMousePosEvent(-FLT_MAX, -FLT_MAX);
+    return false;
+  }
+
+  static bool onWheel(int, EmscriptenWheelEvent const *iEvent, void *iUserData)
+  {
+    from(iUserData).fEventCount++;
+    // same scale as the GLFW backend (1 "line" = 100 pixels)
+    float multiplier = 1.0f / 100.0f;
+    if(iEvent->deltaMode == DOM_DELTA_LINE)
+      multiplier = 1.0f / 3.0f;
+    else if(iEvent->deltaMode == DOM_DELTA_PAGE)
+      multiplier = 80.0f;
+    ImGui::GetIO().AddMouseWheelEvent(static_cast<float>(-iEvent->deltaX) * multiplier,
+                                      static_cast<float>(-iEvent->deltaY) * multiplier);
+    return false;
+  }
+
+  static bool onKey(int iEventType, EmscriptenKeyboardEvent const *iEvent, void *iUserData)
+  {
+    from(iUserData).fEventCount++;
+    ImGuiIO &io = ImGui::GetIO();
+    bool down = iEventType == EMSCRIPTEN_EVENT_KEYDOWN;
+    addModifiers(iEvent->ctrlKey, iEvent->shiftKey, iEvent->altKey, iEvent->metaKey);
+    auto key = toImGuiKey(iEvent->code);
+    if(key != ImGuiKey_None)
+      io.AddKeyEvent(key, down);
+
+    // printable keys have a single character name ("a", "é", ...) unlike the others ("Enter", "Tab", ...)
+    if(down && !iEvent->ctrlKey && !iEvent->metaKey && isSingleCharacter(iEvent->key))
+      io.AddInputCharactersUTF8(iEvent->key);
+    return false;
+  }
+
+  static bool onFocus(int iEventType, EmscriptenFocusEvent const *, void *iUserData)
+  {
+    from(iUserData).fEventCount++;
+    ImGui::GetIO().AddFocusEvent(iEventType == EMSCRIPTEN_EVENT_FOCUS);
+    return false;
+  }
+
+  static bool onResize(int, EmscriptenUiEvent const *iEvent, void *iUserData)
+  {
+    auto &platform = from(iUserData);
+    platform.fEventCount++;
+    // the canvas fills the window: no need to query its css size (a synchronous call to the main thread from a
+    // pthread), the pixel ratio may have changed (browser zoom)
+    platform.fCssWidth = iEvent->windowInnerWidth;
+    platform.fCssHeight = iEvent->windowInnerHeight;
+    platform.fPixelRatio = static_cast<float>(emscripten_get_device_pixel_ratio());
+    return false;
+  }
+
+  static bool isSingleCharacter(char const *iUTF8)
+  {
+    auto c = static_cast<unsigned char>(iUTF8[0]);
+    if(c < 0x20)
+      return false;
+    size_t length = c < 0x80 ? 1 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+    return std::strlen(iUTF8) == length;
+  }
+
+  // Maps KeyboardEvent.code (the physical key) to ImGuiKey
+  static ImGuiKey toImGuiKey(char const *iCode)
+  {
+    auto startsWith = [iCode](char const *iPrefix, size_t iLength) { return std::strncmp(iCode, iPrefix, iLength) == 0; };
+
+    if(startsWith("Key", 3) && iCode[3] >= 'A' && iCode[3] <= 'Z' && iCode[4] == 0)
+      return static_cast<ImGuiKey>(ImGuiKey_A + (iCode[3] - 'A'));
+    if(startsWith("Digit", 5) && iCode[5] >= '0' && iCode[5] <= '9' && iCode[6] == 0)
+      return static_cast<ImGuiKey>(ImGuiKey_0 + (iCode[5] - '0'));
+    if(startsWith("Numpad", 6) && iCode[6] >= '0' && iCode[6] <= '9' && iCode[7] == 0)
+      return static_cast<ImGuiKey>(ImGuiKey_Keypad0 + (iCode[6] - '0'));
+    if(iCode[0] == 'F' && iCode[1] >= '1' && iCode[1] <= '9')
+    {
+      int n = std::atoi(iCode + 1);
+      if(n >= 1 && n <= 24)
+        return static_cast<ImGuiKey>(ImGuiKey_F1 + (n - 1));
+    }
+
+    struct Entry
+    {
+      char const *fCode;
+      ImGuiKey fKey;
+    };
+    static constexpr Entry kKeys[] = {
+      {"Tab", ImGuiKey_Tab}, {"ArrowLeft", ImGuiKey_LeftArrow}, {"ArrowRight", ImGuiKey_RightArrow},
+      {"ArrowUp", ImGuiKey_UpArrow}, {"ArrowDown", ImGuiKey_DownArrow}, {"PageUp", ImGuiKey_PageUp},
+      {"PageDown", ImGuiKey_PageDown}, {"Home", ImGuiKey_Home}, {"End", ImGuiKey_End},
+      {"Insert", ImGuiKey_Insert}, {"Delete", ImGuiKey_Delete}, {"Backspace", ImGuiKey_Backspace},
+      {"Space", ImGuiKey_Space}, {"Enter", ImGuiKey_Enter}, {"Escape", ImGuiKey_Escape},
+      {"ControlLeft", ImGuiKey_LeftCtrl}, {"ShiftLeft", ImGuiKey_LeftShift}, {"AltLeft", ImGuiKey_LeftAlt},
+      {"MetaLeft", ImGuiKey_LeftSuper}, {"ControlRight", ImGuiKey_RightCtrl}, {"ShiftRight", ImGuiKey_RightShift},
+      {"AltRight", ImGuiKey_RightAlt}, {"MetaRight", ImGuiKey_RightSuper}, {"ContextMenu", ImGuiKey_Menu},
+      {"Quote", ImGuiKey_Apostrophe}, {"Comma", ImGuiKey_Comma}, {"Minus", ImGuiKey_Minus},
+      {"Period", ImGuiKey_Period}, {"Slash", ImGuiKey_Slash}, {"Semicolon", ImGuiKey_Semicolon},
+      {"Equal", ImGuiKey_Equal}, {"BracketLeft", ImGuiKey_LeftBracket}, {"Backslash", ImGuiKey_Backslash},
+      {"BracketRight", ImGuiKey_RightBracket}, {"Backquote", ImGuiKey_GraveAccent},
+      {"CapsLock", ImGuiKey_CapsLock}, {"ScrollLock", ImGuiKey_ScrollLock}, {"NumLock", ImGuiKey_NumLock},
+      {"PrintScreen", ImGuiKey_PrintScreen}, {"Pause", ImGuiKey_Pause},
+      {"NumpadDecimal", ImGuiKey_KeypadDecimal}, {"NumpadDivide", ImGuiKey_KeypadDivide},
+      {"NumpadMultiply", ImGuiKey_KeypadMultiply}, {"NumpadSubtract", ImGuiKey_KeypadSubtract},
+      {"NumpadAdd", ImGuiKey_KeypadAdd}, {"NumpadEnter", ImGuiKey_KeypadEnter}, {"NumpadEqual", ImGuiKey_KeypadEqual},
+    };
+    for(auto const &entry: kKeys)
+    {
+      if(std::strcmp(iCode, entry.fCode) == 0)
+        return entry.fKey;
+    }
+    return ImGuiKey_None;
+  }
+
+private:
+  char const *fCanvasSelector{};
+  int fCssWidth{};
+  int fCssHeight{};
+  float fPixelRatio{1.0f};
+  SurfaceResizer fResizer{};
+  double fTime{};
+  int fEventCount{};
+};
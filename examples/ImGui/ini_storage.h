@@ -0,0 +1,185 @@
+// Persistent ImGui settings (imgui.ini) shared by the examples
+//
+// With emscripten, imgui.ini would be written to the in-memory file system (MEMFS) and lost on every reload, so the
+// examples set io.IniFilename = nullptr. IniStorage persists the settings (window positions and sizes, tables,
+// docking layout with branch=docking) in IndexedDB (IDBFS) instead, without ever blocking a frame:
+// - load() mounts IDBFS and starts the (asynchronous) copy from IndexedDB to memory while the application is set up.
+//   ready() returns false until it is done, so the first frame waits for it, and then loads the settings with
+//   ImGui::LoadIniSettingsFromMemory() (before the first ImGui::NewFrame())
+// - update() saves the settings when ImGui requests it (io.WantSaveIniSettings, at most every io.IniSavingRate
+//   seconds) to the in-memory file, and the copy to IndexedDB (FS.syncfs) runs in the background once the settings
+//   have not changed for fSyncDelayMs (a single copy at a time, and the changes made in the meantime are copied
+//   right after). The pending changes are also copied when the page is hidden or closed
+//
+// Requires linking with -lidbfs.js. When IndexedDB is not available (or does not answer within fLoadTimeoutMs),
+// the settings are only kept in memory (by ImGui): the file is then neither read nor written. The copy from
+// IndexedDB cannot be cancelled, so when it completes after the timeout it (harmlessly) replaces a file nobody uses,
+// and nothing is ever copied back to IndexedDB (which keeps the settings saved by the previous session).
+
+#pragma once
+
+#include <imgui.h>
+#include <imgui_internal.h>
+#include <emscripten.h>
+#include <cstdio>
+#include <string>
+#include <utility>
+
+EM_JS_DEPS(ini_storage, "$FS,$IDBFS,$UTF8ToString");
+
+// Mounts IDBFS and starts copying its content from IndexedDB (Module.iniStorage.state: 0 = loading, 1 = loaded,
+// -1 = IndexedDB not available)
+EM_JS(void, IniStorage_Load, (char const *iMountPoint, double iTimeoutMs), {
+  const mountPoint = UTF8ToString(iMountPoint);
+  const storage = Module['iniStorage'] = {state: 0, syncing: false, dirty: false, timer: null, syncs: 0};
+  const done = (err) => {
+    if(storage.state !== 0)
+    {
+      if(storage.state < 0 && err !== 'timeout')
+        console.warn('IniStorage: IndexedDB answered after the timeout (ignored)');
+      return;
+    }
+    if(err)
+      console.warn('IniStorage: settings not persisted (' + err + ')');
+    storage.state = err ? -1 : 1;
+  };
+  // copies the in-memory files to IndexedDB
+  storage.sync = () => {
+    clearTimeout(storage.timer);
+    storage.timer = null;
+    if(storage.state !== 1 || storage.syncing || !storage.dirty)
+      return;
+    storage.syncing = true;
+    storage.dirty = false;
+    FS.syncfs(false, (err) => {
+      storage.syncing = false;
+      storage.syncs++;
+      if(err)
+      {
+        console.warn('IniStorage: cannot save the settings (' + err + ')');
+        storage.dirty = true; // retried with the next change
+      }
+      else if(storage.dirty)
+        storage.sync(); // changed during the copy
+    });
+  };
+  window.addEventListener('pagehide', () => storage.sync());
+  document.addEventListener('visibilitychange', () => {
+    if(document.visibilityState === 'hidden')
+      storage.sync();
+  });
+  try
+  {
+    FS.mkdirTree(mountPoint);
+    FS.mount(IDBFS, {}, mountPoint);
+    FS.syncfs(true, done);
+    setTimeout(() => done('timeout'), iTimeoutMs);
+  }
+  catch(e)
+  {
+    done(e);
+  }
+});
+
+EM_JS(int, IniStorage_GetState, (), {
+  const storage = Module['iniStorage'];
+  return storage ? storage.state : 0;
+});
+
+// Called after writing a file: the copy to IndexedDB starts once nothing has been written for iDelayMs
+EM_JS(void, IniStorage_ScheduleSync, (double iDelayMs), {
+  const storage = Module['iniStorage'];
+  storage.dirty = true;
+  clearTimeout(storage.timer);
+  storage.timer = setTimeout(() => storage.sync(), iDelayMs);
+});
+
+EM_JS(int, IniStorage_GetSyncCount, (), {
+  const storage = Module['iniStorage'];
+  return storage ? storage.syncs : 0;
+});
+
+class IniStorage
+{
+public:
+  // each example has its own file (the IndexedDB database is shared by all the pages of the origin)
+  explicit IniStorage(std::string iPath = "/imgui/imgui.ini", std::string iMountPoint = "/imgui") :
+    fPath{std::move(iPath)}, fMountPoint{std::move(iMountPoint)} {}
+
+  std::string fPath;
+  std::string fMountPoint;
+  double fSyncDelayMs{1000};
+  double fLoadTimeoutMs{1000};
+
+  // Starts loading the settings from IndexedDB: call as early as possible (the ImGui context is not required)
+  void load()
+  {
+    IniStorage_Load(fMountPoint.c_str(), fLoadTimeoutMs);
+    fLoading = true;
+  }
+
+  // Returns false while the settings are being loaded: skip the frame (and call again next frame). Loads the settings
+  // in ImGui when done (must happen before the first ImGui::NewFrame())
+  bool ready()
+  {
+    if(!fLoading)
+      return true;
+    auto state = IniStorage_GetState();
+    if(state == 0)
+      return false;
+    fLoading = false;
+    fPersistent = state > 0;
+    // after a timeout, the copy from IndexedDB may still be writing to the file: ignored
+    if(!fPersistent)
+      return true;
+    if(auto file = fopen(fPath.c_str(), "rb"))
+    {
+      std::string settings{};
+      char buffer[4096];
+      size_t size;
+      while((size = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        settings.append(buffer, size);
+      fclose(file);
+      ImGui::LoadIniSettingsFromMemory(settings.data(), settings.size());
+      fLoadedBytes = settings.size();
+    }
+    return true;
+  }
+
+  // Call once per frame (after ImGui::NewFrame()). Returns true while some settings changes are not saved yet (ImGui
+  // only counts down io.IniSavingRate while frames are rendered: an event-driven main loop must keep running)
+  bool update()
+  {
+    auto &io = ImGui::GetIO();
+    if(io.WantSaveIniSettings)
+    {
+      io.WantSaveIniSettings = false;
+      // not persistent: ImGui keeps the settings in memory, there is no point in writing the file
+      if(!fPersistent)
+        return false;
+      size_t size = 0;
+      auto settings = ImGui::SaveIniSettingsToMemory(&size);
+      // in-memory file (MEMFS): no I/O
+      if(auto file = fopen(fPath.c_str(), "wb"))
+      {
+        fwrite(settings, 1, size, file);
+        fclose(file);
+        fSaves++;
+        IniStorage_ScheduleSync(fSyncDelayMs);
+      }
+    }
+    return ImGui::GetCurrentContext()->SettingsDirtyTimer > 0.0f;
+  }
+
+  bool isPersistent() const { return fPersistent; }
+  size_t getLoadedBytes() const { return fLoadedBytes; }
+  int getSaveCount() const { return fSaves; }
+  // number of copies to IndexedDB
+  int getSyncCount() const { return IniStorage_GetSyncCount(); }
+
+private:
+  bool fLoading{false};
+  bool fPersistent{false}; // false when IndexedDB is not available (or did not answer in time)
+  size_t fLoadedBytes{};
+  int fSaves{};
+};
@@ -0,0 +1,130 @@
+// Input event coalescing shared by the examples
+//
+// The GLFW and SDL2 backends queue one ImGui input event per browser event. A high rate pointer (1000 Hz mouse, pen
+// tablet, trackpad scrolling) queues many mouse move and wheel events per frame. With io.ConfigInputTrickleEventQueue
+// (the default), ImGui processes at most one "kind" of mouse event per frame: every time the queue alternates between
+// move and wheel events, the rest of the queue is deferred to the next frame, so the input lags behind by several
+// frames. InputCoalescer::coalesce(), called right before ImGui::NewFrame(), rewrites the ImGui input queue: each run
+// of adjacent events of the same type (from the same source) is merged into one event, a run of mouse moves into the
+// last position and a run of wheel events into the sum of their deltas. No event is reordered (a move and a wheel are
+// never merged with each other), so the queue is shorter and alternates less, but is processed in the same order.
+// Button, key, text and focus events are never merged, so a fast click (down + up in the same frame) is still seen by
+// ImGui.
+//
+// InputCoalescer::measureLatency() measures the input latency: the time from the oldest DOM input event
+// (event.timeStamp) to the submission of the frame which processed the last of the ImGui events it generated.
+
+#pragma once
+
+#include <imgui.h>
+#include <imgui_internal.h>
+#include <emscripten.h>
+
+// The listeners are registered on the capture phase so that they do not interfere with the GLFW/SDL ones
+EM_JS(void, InputCoalescer_InstallLatencyListeners, (), {
+  const state = Module['inputLatency'] = {pending: 0, oldest: 0};
+  const onInput = (e) => {
+    if(state.pending++ === 0)
+      state.oldest = e.timeStamp;
+  };
+  const options = {capture: true, passive: true};
+  const target = Module['canvas'] || window;
+  ['pointermove', 'pointerdown', 'pointerup', 'wheel'].forEach(type => target.addEventListener(type, onInput, options));
+  ['keydown', 'keyup'].forEach(type => window.addEventListener(type, onInput, options));
+});
+
+// Returns the timestamp (performance.now() time base) of the oldest input event since the previous call, or -1
+EM_JS(double, InputCoalescer_TakeOldestEventTime, (), {
+  const state = Module['inputLatency'];
+  if(!state || state.pending === 0)
+    return -1;
+  state.pending = 0;
+  return state.oldest;
+});
+
+class InputCoalescer
+{
+public:
+  bool fEnabled{true};
+
+  // Call after the backend NewFrame (which may queue events as well) and before ImGui::NewFrame()
+  void coalesce()
+  {
+    if(!fListenersInstalled)
+    {
+      fListenersInstalled = true;
+      InputCoalescer_InstallLatencyListeners();
+    }
+
+    auto &queue = ImGui::GetCurrentContext()->InputEventsQueue;
+    fEventsIn = queue.Size;
+    if(fEnabled)
+    {
+      // compacts the queue in place (out <= i): an event is either merged into the last one written or appended
+      int out = 0;
+      for(int i = 0; i < queue.Size; i++)
+      {
+        auto const &e = queue[i];
+        if(out > 0 && canMerge(queue[out - 1], e))
+        {
+          auto &previous = queue[out - 1];
+          if(e.Type == ImGuiInputEventType_MousePos)
+            previous = e; // last position
+          else
+          {
+            previous.MouseWheel.WheelX += e.MouseWheel.WheelX;
+            previous.MouseWheel.WheelY += e.MouseWheel.WheelY;
+          }
+          continue;
+        }
+        queue[out++] = e;
+      }
+      queue.resize(out);
+    }
+    fEventsOut = queue.Size;
+    fTotalEventsIn += fEventsIn;
+    fTotalEventsOut += fEventsOut;
+  }
+
+  // Call when the frame has been submitted. Returns the input latency in ms, or a negative value if there was no input
+  // since the previous measure or if ImGui has not processed all the events yet (trickled to the next frames).
+  float measureLatency(double iNowMs) const
+  {
+    if(ImGui::GetCurrentContext()->InputEventsQueue.Size > 0)
+      return -1.0f;
+    auto oldest = InputCoalescer_TakeOldestEventTime();
+    if(oldest <= 0 || oldest > iNowMs)
+      return -1.0f;
+    return static_cast<float>(iNowMs - oldest);
+  }
+
+  // Statistics: number of ImGui input events queued by the backend vs left after coalescing (total)
+  long long getTotalEventsIn() const { return fTotalEventsIn; }
+  long long getTotalEventsOut() const { return fTotalEventsOut; }
+
+private:
+  static bool isMouseMoveOrWheel(ImGuiInputEvent const &iEvent)
+  {
+    return iEvent.Type == ImGuiInputEventType_MousePos || iEvent.Type == ImGuiInputEventType_MouseWheel;
+  }
+
+  static ImGuiMouseSource getMouseSource(ImGuiInputEvent const &iEvent)
+  {
+    return iEvent.Type == ImGuiInputEventType_MousePos ? iEvent.MousePos.MouseSource : iEvent.MouseWheel.MouseSource;
+  }
+
+  // only adjacent mouse moves (or wheels) from the same source are merged, so the order of the events is kept
+  static bool canMerge(ImGuiInputEvent const &iPrevious, ImGuiInputEvent const &iEvent)
+  {
+    return iPrevious.Type == iEvent.Type && isMouseMoveOrWheel(iEvent) &&
+           getMouseSource(iPrevious) == getMouseSource(iEvent);
+  }
+
+  // Statistics: number of ImGui input events queued by the backend vs left after coalescing (last frame and total)
+  int fEventsIn{};
+  int fEventsOut{};
+  long long fTotalEventsIn{};
+  long long fTotalEventsOut{};
+
+  bool fListenersInstalled{false};
+};
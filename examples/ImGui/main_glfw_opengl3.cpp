@@ -10,6 +10,15 @@
 #include <imgui.h>
 #include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_opengl3.h>
+#ifdef IMGUI_IMPL_WEBGL2
+#include <imgui_impl_webgl2.h>
+#endif
+#ifdef IMGUI_BAKED_FONTS
+#include <imgui_baked_fonts.h>
+#endif
+#ifdef IMGUI_LAZY_DEMO
+#include <imgui_lazy_demo.h>
+#endif
 #include <stdio.h>
 
 #define GL_SILENCE_DEPRECATION
@@ -22,23 +31,9 @@
 #include <emscripten/version.h>
 #include <emscripten.h>
 #include <functional>
-
-struct App
-{
-  std::function<bool()> renderFrame{};
-  std::function<void()> cleanup{};
-};
-
-static void MainLoopForEmscripten(void *iUserData)
-{
-  auto app = reinterpret_cast<App *>(iUserData);
-  if(app->renderFrame())
-  {
-    if(app->cleanup)
-      app->cleanup();
-    emscripten_cancel_main_loop();
-  }
-}
+#include "app.h"
+#include "input_coalescer.h"
+#include "ini_storage.h"
 
 static void glfw_error_callback(int error, const char *description)
 {
@@ -56,6 +51,10 @@ int main(int, char **)
   printf("GLFW: %s\n", glfwGetVersionString());
   printf("ImGui: %s\n", IMGUI_VERSION);
 
+  // starts loading the ImGui settings from IndexedDB while the application is set up (see ini_storage.h)
+  IniStorage ini_storage{"/imgui/glfw_opengl3.ini"};
+  ini_storage.load();
+
   // Decide GL+GLSL versions
   // GL ES 2.0 + GLSL 100
   const char* glsl_version = "#version 100";
@@ -93,22 +92,39 @@ int main(int, char **)
   style.ScaleAllSizes(main_scale);        // Bake a fixed style scale. (until we have a solution for dynamic style scaling, changing this requires resetting Style + calling this again)
   style.FontScaleDpi = main_scale;        // Set initial font scale. (using io.ConfigDpiScaleFonts=true makes this unnecessary. We leave both here for documentation purpose)
 
+#ifdef IMGUI_BAKED_FONTS
+  // the glyphs baked at build time (bakedFonts port option) are copied into the atlas instead of being rasterized
+  ImGui_BakedFonts_Install(io.Fonts);
+#endif
+
   // Setup Platform/Renderer backends
   ImGui_ImplGlfw_InitForOpenGL(window, true);
   // makes the canvas resizable and match the full window size
   emscripten_glfw_make_canvas_resizable(window, "window", nullptr);
   ImGui_ImplOpenGL3_Init(glsl_version);
+#ifdef IMGUI_IMPL_WEBGL2
+  // the example only clears the framebuffer: no need to save/restore the GL state around ImGui
+  ImGui_ImplWebGL2_SetOwnsContext(true);
+#endif
 
   // Our state
   bool show_demo_window = true;
   bool show_another_window = false;
+  InputCoalescer input_coalescer{};
   ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
 
-  // no filesystem access with emscripten
+  // imgui.ini is not written by ImGui (the file system is in memory): see ini_storage
   io.IniFilename = nullptr;
 
   App app{};
   app.renderFrame = [&]() {
+    // the first frame waits for the settings (loaded asynchronously from IndexedDB, see ini_storage.h)
+    if(!ini_storage.ready())
+    {
+      app.invalidate();
+      return false;
+    }
+
     // Poll and handle events (inputs, window resize, etc.)
     // You can read the io.WantCaptureMouse, io.WantCaptureKeyboard flags to tell if dear imgui wants to use your inputs.
     // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application, or clear/overwrite your copy of the mouse data.
@@ -119,7 +135,12 @@ int main(int, char **)
     // Start the Dear ImGui frame
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
+    // merges the mouse move/wheel events queued since the previous frame (see input_coalescer.h)
+    input_coalescer.coalesce();
     ImGui::NewFrame();
+    // saves the settings when they change (written to IndexedDB in the background)
+    if(ini_storage.update())
+      app.invalidate();
 
 #ifdef IMGUI_ENABLE_DOCKING
     ImGui::DockSpaceOverViewport(ImGui::GetMainViewport()->ID);
@@ -128,8 +149,17 @@ int main(int, char **)
 #ifndef IMGUI_DISABLE_DEMO
     // 1. Show the big demo window (Most of the sample code is in ImGui::ShowDemoWindow()! You can browse its code to learn more about Dear ImGui!).
     if(show_demo_window)
+    {
+#ifdef IMGUI_LAZY_DEMO
+      // the demo is fetched (imgui_demo.wasm) the first time it is shown (see imgui_lazy_demo.h)
+      ImGui_LazyDemo_ShowDemoWindow(&show_demo_window);
+      if(ImGui_LazyDemo_GetStatus() == ImGui_LazyDemo_Status_Loading)
+        app.invalidate(); // keeps the main loop running until the demo is loaded
+#else
       ImGui::ShowDemoWindow(&show_demo_window);
 #endif
+    }
+#endif
 
     // 2. Show a simple window that we create ourselves. We use a Begin/End pair to create a named window.
     {
@@ -170,6 +200,13 @@ int main(int, char **)
       ImGui::End();
     }
 
+#ifdef IMGUI_IMPL_WEBGL2
+    // the texture updates are uploaded within a budget of bytes per frame: keeps the main loop running until the
+    // deferred ones are uploaded (see imgui_impl_webgl2.h)
+    if(ImGui_ImplWebGL2_GetStats().TexturePendingBytes > 0)
+      app.invalidate();
+#endif
+
     // Rendering
     ImGui::Render();
     int display_w, display_h;
@@ -192,6 +229,9 @@ int main(int, char **)
     glfwTerminate();
   };
 
+  // suspends the main loop while the application is idle (no input, resize, ...)
+  app.eventDriven = true;
+
   emscripten_set_main_loop_arg(MainLoopForEmscripten, &app, 0, true);
 
   return 0;
@@ -0,0 +1,273 @@
+// Dear ImGui: GLFW + OpenGL 3 example instrumented for diagnostics and stress tests
+// (same application as main_glfw_opengl3.cpp, with the tooling shared by the examples in a "Diagnostics" window)
+
+// Learn about Dear ImGui:
+// - FAQ                  https://dearimgui.com/faq
+// - Getting Started      https://dearimgui.com/getting-started
+// - Documentation        https://dearimgui.com/docs (same as your local docs/ folder).
+// - Introduction, links and more at the top of imgui.cpp
+
+#include <imgui.h>
+#include <backends/imgui_impl_glfw.h>
+#include <backends/imgui_impl_opengl3.h>
+#ifdef IMGUI_IMPL_WEBGL2
+#include <imgui_impl_webgl2.h>
+#endif
+#ifdef IMGUI_BAKED_FONTS
+#include <imgui_baked_fonts.h>
+#endif
+#include <stdio.h>
+
+#define GL_SILENCE_DEPRECATION
+#if defined(IMGUI_IMPL_OPENGL_ES2)
+#include <GLES2/gl2.h>
+#endif
+
+#include <GLFW/glfw3.h> // Will drag system OpenGL headers
+#include <GLFW/emscripten_glfw3.h>
+#include <emscripten/version.h>
+#include <emscripten.h>
+#include <functional>
+#include "app.h"
+#include "frame_stats.h"
+#include "input_coalescer.h"
+#include "glyph_burst.h"
+#include "ini_storage.h"
+
+static void glfw_error_callback(int error, const char *description)
+{
+  fprintf(stderr, "GLFW Error %d: %s\n", error, description);
+}
+
+// Main code
+int main(int, char **)
+{
+  glfwSetErrorCallback(glfw_error_callback);
+  if(!glfwInit())
+    return 1;
+
+  printf("Emscripten: %d.%d.%d\n", __EMSCRIPTEN_MAJOR__, __EMSCRIPTEN_MINOR__, __EMSCRIPTEN_TINY__);
+  printf("GLFW: %s\n", glfwGetVersionString());
+  printf("ImGui: %s\n", IMGUI_VERSION);
+
+  // starts loading the ImGui settings from IndexedDB while the application is set up (see ini_storage.h)
+  IniStorage ini_storage{"/imgui/glfw_opengl3_diagnostics.ini"};
+  ini_storage.load();
+
+  // Decide GL+GLSL versions
+  // GL ES 2.0 + GLSL 100
+  const char* glsl_version = "#version 100";
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+  glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_ES_API);
+
+  float main_scale = ImGui_ImplGlfw_GetContentScaleForMonitor(glfwGetPrimaryMonitor()); // Valid on GLFW 3.3+ only
+
+  // Create window with graphics context
+  GLFWwindow *window = glfwCreateWindow(1280, 720, "Dear ImGui GLFW+OpenGL3 diagnostics example", nullptr, nullptr);
+  if(window == nullptr)
+    return 1;
+  glfwMakeContextCurrent(window);
+
+  // Setup Dear ImGui context
+  IMGUI_CHECKVERSION();
+  ImGui::CreateContext();
+  ImGuiIO &io = ImGui::GetIO();
+  (void) io;
+  io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;     // Enable Keyboard Controls
+  io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;      // Enable Gamepad Controls
+
+#ifdef IMGUI_ENABLE_DOCKING
+  io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
+  io.ConfigDockingWithShift = false;
+#endif
+
+  // Setup Dear ImGui style
+  ImGui::StyleColorsDark();
+  //ImGui::StyleColorsLight();
+
+  // Setup scaling
+  ImGuiStyle &style = ImGui::GetStyle();
+  style.ScaleAllSizes(main_scale);        // Bake a fixed style scale. (until we have a solution for dynamic style scaling, changing this requires resetting Style + calling this again)
+  style.FontScaleDpi = main_scale;        // Set initial font scale. (using io.ConfigDpiScaleFonts=true makes this unnecessary. We leave both here for documentation purpose)
+
+#ifdef IMGUI_BAKED_FONTS
+  // the glyphs baked at build time (bakedFonts port option) are copied into the atlas instead of being rasterized
+  ImGui_BakedFonts_Install(io.Fonts);
+#endif
+
+  // Setup Platform/Renderer backends
+  ImGui_ImplGlfw_InitForOpenGL(window, true);
+  // makes the canvas resizable and match the full window size
+  emscripten_glfw_make_canvas_resizable(window, "window", nullptr);
+  ImGui_ImplOpenGL3_Init(glsl_version);
+#ifdef IMGUI_IMPL_WEBGL2
+  // the example only clears the framebuffer: no need to save/restore the GL state around ImGui
+  ImGui_ImplWebGL2_SetOwnsContext(true);
+#endif
+
+  // Our state
+  bool show_demo_window = true;
+  bool show_another_window = false;
+  bool show_frame_stats = true;
+  GlyphBurst glyph_burst{};
+  InputCoalescer input_coalescer{};
+  ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
+
+  // imgui.ini is not written by ImGui (the file system is in memory): see ini_storage
+  io.IniFilename = nullptr;
+
+  App app{};
+  app.renderFrame = [&]() {
+    // the first frame waits for the settings (loaded asynchronously from IndexedDB, see ini_storage.h)
+    if(!ini_storage.ready())
+    {
+      app.invalidate();
+      return false;
+    }
+
+    gFrameStats.beginFrame();
+
+    // Poll and handle events (inputs, window resize, etc.)
+    // You can read the io.WantCaptureMouse, io.WantCaptureKeyboard flags to tell if dear imgui wants to use your inputs.
+    // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application, or clear/overwrite your copy of the mouse data.
+    // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application, or clear/overwrite your copy of the keyboard data.
+    // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
+    glfwPollEvents();
+    gFrameStats.mark(FramePhase::PollEvents);
+
+    // Start the Dear ImGui frame
+    ImGui_ImplOpenGL3_NewFrame();
+    ImGui_ImplGlfw_NewFrame();
+    // merges the mouse move/wheel events queued since the previous frame (see input_coalescer.h)
+    input_coalescer.coalesce();
+    ImGui::NewFrame();
+    gFrameStats.mark(FramePhase::NewFrame);
+    // saves the settings when they change (written to IndexedDB in the background)
+    if(ini_storage.update())
+      app.invalidate();
+
+#ifdef IMGUI_ENABLE_DOCKING
+    ImGui::DockSpaceOverViewport(ImGui::GetMainViewport()->ID);
+#endif
+
+#ifndef IMGUI_DISABLE_DEMO
+    // 1. Show the big demo window (Most of the sample code is in ImGui::ShowDemoWindow()! You can browse its code to learn more about Dear ImGui!).
+    if(show_demo_window)
+      ImGui::ShowDemoWindow(&show_demo_window);
+#endif
+
+    // 2. Show a simple window that we create ourselves. We use a Begin/End pair to create a named window.
+    {
+      static float f = 0.0f;
+      static int counter = 0;
+
+      ImGui::Begin(
+        "Hello, world!");                          // Create a window called "Hello, world!" and append into it.
+
+      ImGui::Text("This is some useful text.");               // Display some text (you can use a format strings too)
+      ImGui::Checkbox("Demo Window", &show_demo_window);      // Edit bools storing our window open/close state
+      ImGui::Checkbox("Another Window", &show_another_window);
+
+      ImGui::SliderFloat("float", &f, 0.0f, 1.0f);            // Edit 1 float using a slider from 0.0f to 1.0f
+      ImGui::ColorEdit3("clear color", (float *) &clear_color); // Edit 3 floats representing a color
+
+      if(ImGui::Button(
+        "Button"))                            // Buttons return true when clicked (most widgets return true when edited/activated)
+        counter++;
+      ImGui::SameLine();
+      ImGui::Text("counter = %d", counter);
+
+      if(ImGui::Button("Exit"))
+        glfwSetWindowShouldClose(window, GLFW_TRUE);
+
+      ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / io.Framerate, io.Framerate);
+      ImGui::End();
+    }
+
+    // 3. Show another simple window.
+    if(show_another_window)
+    {
+      ImGui::Begin("Another Window",
+                   &show_another_window);   // Pass a pointer to our bool variable (the window will have a closing button that will clear the bool when clicked)
+      ImGui::Text("Hello from another window!");
+      if(ImGui::Button("Close Me"))
+        show_another_window = false;
+      ImGui::End();
+    }
+
+    // 4. Show the diagnostics window
+    {
+      ImGui::Begin("Diagnostics");
+      ImGui::Checkbox("Frame stats", &show_frame_stats);
+      ImGui::Checkbox("Coalesce input events", &input_coalescer.fEnabled);
+      ImGui::Text("Input: %lld ImGui events queued, %lld after coalescing", input_coalescer.getTotalEventsIn(),
+                  input_coalescer.getTotalEventsOut());
+      ImGui::Text("Settings: %zu bytes loaded, %d saves, %d copies to IndexedDB%s", ini_storage.getLoadedBytes(),
+                  ini_storage.getSaveCount(), ini_storage.getSyncCount(), ini_storage.isPersistent() ? "" : " (not available)");
+#ifdef IMGUI_BAKED_FONTS
+      auto baked_fonts_stats = ImGui_BakedFonts_GetStats();
+      ImGui::Text("Fonts: %d glyphs copied from the blob, %d rasterized", baked_fonts_stats.CopiedGlyphs,
+                  baked_fonts_stats.RasterizedGlyphs);
+#endif
+#ifdef IMGUI_IMPL_WEBGL2
+      // stats of the previous frame (the stock renderer issues 1 draw call and ~3 GL calls per ImDrawCmd)
+      auto webgl2_stats = ImGui_ImplWebGL2_GetStats();
+      ImGui::Text("webgl2: %d draw calls for %d ImDrawCmd", webgl2_stats.DrawCalls, webgl2_stats.DrawCommands);
+      ImGui::Text("webgl2: %d GL calls (%.1f KB uploaded)", webgl2_stats.GLCalls, webgl2_stats.UploadBytes / 1024.0f);
+      ImGui::Text("webgl2: %d texture uploads (%.1f KB, %.1f KB pending)", webgl2_stats.TextureUploads,
+                  webgl2_stats.TextureUploadBytes / 1024.0f, webgl2_stats.TexturePendingBytes / 1024.0f);
+      static bool texture_upload_budget = true;
+      if(ImGui::Checkbox("Texture upload budget (256 KB/frame)", &texture_upload_budget))
+        ImGui_ImplWebGL2_SetTextureUploadBudget(texture_upload_budget ? 256 * 1024 : 0);
+      if(webgl2_stats.TexturePendingBytes > 0)
+        app.invalidate(); // keeps the main loop running until the deferred glyphs are uploaded
+#endif
+      glyph_burst.renderControls();
+      ImGui::End();
+    }
+
+    // 5. Show the frame stats overlay
+    if(show_frame_stats)
+      gFrameStats.renderOverlay(&show_frame_stats);
+
+    // 6. Show the text of the last glyph burst (see glyph_burst.h)
+    glyph_burst.renderWindow();
+    gFrameStats.mark(FramePhase::BuildUI);
+
+    // Rendering
+    ImGui::Render();
+    gFrameStats.mark(FramePhase::Render);
+    int display_w, display_h;
+    glfwGetFramebufferSize(window, &display_w, &display_h);
+    glViewport(0, 0, display_w, display_h);
+    glClearColor(clear_color.x * clear_color.w, clear_color.y * clear_color.w, clear_color.z * clear_color.w,
+                 clear_color.w);
+    glClear(GL_COLOR_BUFFER_BIT);
+    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    gFrameStats.mark(FramePhase::RenderDrawData);
+    // nothing to submit: the browser presents the canvas when the frame returns
+    gFrameStats.mark(FramePhase::Submit);
+    if(auto latency = input_coalescer.measureLatency(emscripten_get_now()); latency >= 0)
+      gFrameStats.recordInputLatency(latency);
+    gFrameStats.endFrame(ImGui::GetDrawData());
+
+    return glfwWindowShouldClose(window);
+  };
+
+  app.cleanup = [window]() {
+    ImGui_ImplOpenGL3_Shutdown();
+    ImGui_ImplGlfw_Shutdown();
+    ImGui::DestroyContext();
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+  };
+
+  // suspends the main loop while the application is idle (no input, resize, ...)
+  app.eventDriven = true;
+
+  emscripten_set_main_loop_arg(MainLoopForEmscripten, &app, 0, true);
+
+  return 0;
+}
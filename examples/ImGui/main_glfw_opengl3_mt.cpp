@@ -0,0 +1,342 @@
+// Dear ImGui: standalone example application for GLFW + OpenGL 3, using programmable pipeline
+// (GLFW is a cross-platform general purpose library for handling windows, inputs, OpenGL/Vulkan/Metal graphics context creation, etc.)
+// This example builds the geometry of large plots in parallel on worker threads (see parallel_draw_lists.h)
+// and requires -pthread (and the threads=true port option)
+
+// Learn about Dear ImGui:
+// - FAQ                  https://dearimgui.com/faq
+// - Getting Started      https://dearimgui.com/getting-started
+// - Documentation        https://dearimgui.com/docs (same as your local docs/ folder).
+// - Introduction, links and more at the top of imgui.cpp
+
+#include <imgui.h>
+#include <backends/imgui_impl_glfw.h>
+#include <backends/imgui_impl_opengl3.h>
+#include <stdio.h>
+
+#define GL_SILENCE_DEPRECATION
+#if defined(IMGUI_IMPL_OPENGL_ES2)
+#include <GLES2/gl2.h>
+#endif
+
+#include <GLFW/glfw3.h> // Will drag system OpenGL headers
+#include <GLFW/emscripten_glfw3.h>
+#include <emscripten/version.h>
+#include <emscripten.h>
+#include <emscripten/threading.h>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "app.h"
+#include "frame_stats.h"
+#include "parallel_draw_lists.h"
+
+// must match -sPTHREAD_POOL_SIZE (the calling thread is also used to run jobs)
+static constexpr int kMaxThreadCount = 8;
+
+// each job generates less than 64k vertices (required with 16-bit indices)
+static constexpr int kPointsPerJob = 8192;
+
+// Generates the points [iFirstPoint, iLastPoint] of a noisy sine wave fitting in [iMin, iMax] and draws them
+static void DrawPlotChunk(ImDrawList *iDrawList, ImVec2 iMin, ImVec2 iMax, int iPlot, int iFirstPoint, int iLastPoint,
+                          int iPointCount, float iTime)
+{
+  thread_local std::vector<ImVec2> points{};
+  points.resize(iLastPoint - iFirstPoint + 1);
+
+  auto width = iMax.x - iMin.x;
+  auto halfHeight = (iMax.y - iMin.y) * 0.5f;
+  for(int i = iFirstPoint; i <= iLastPoint; i++)
+  {
+    auto x = static_cast<float>(i) / static_cast<float>(iPointCount - 1);
+    auto hash = static_cast<unsigned int>(i) * 2654435761u ^ static_cast<unsigned int>(iPlot) * 40503u;
+    auto noise = static_cast<float>(hash % 1024) / 1024.0f - 0.5f;
+    auto y = std::sin(x * 6.2831853f * static_cast<float>(iPlot + 1) + iTime) * 0.8f + noise * 0.15f;
+    points[i - iFirstPoint] = ImVec2(iMin.x + x * width, iMin.y + halfHeight * (1.0f - y));
+  }
+
+  iDrawList->AddPolyline(points.data(), static_cast<int>(points.size()), IM_COL32(255, 200, 0, 255), ImDrawFlags_None,
+                         1.0f);
+}
+
+// Measures the time it takes to build the geometry with 1, 2, 4 and 8 threads
+struct ScalingBenchmark
+{
+  static constexpr int kThreadCounts[] = {1, 2, 4, 8};
+  static constexpr int kRunCount = IM_ARRAYSIZE(kThreadCounts);
+  static constexpr int kFramesPerRun = 120;
+
+  bool isRunning() const { return fRun >= 0; }
+  int getThreadCount() const { return kThreadCounts[fRun]; }
+
+  void start()
+  {
+    fRun = 0;
+    fFrame = 0;
+    fAccumulatedMs = 0;
+  }
+
+  void recordFrame(double iBuildMs)
+  {
+    // skips the first frames of each run (threads warming up)
+    if(fFrame++ >= 10)
+      fAccumulatedMs += iBuildMs;
+    if(fFrame == kFramesPerRun)
+    {
+      fResultsMs[fRun] = fAccumulatedMs / (kFramesPerRun - 10);
+      printf("[benchmark] %d thread(s): %.3f ms/frame\n", kThreadCounts[fRun], fResultsMs[fRun]);
+      fFrame = 0;
+      fAccumulatedMs = 0;
+      if(++fRun == kRunCount)
+      {
+        fRun = -1;
+        fHasResults = true;
+      }
+    }
+  }
+
+  void renderResults() const
+  {
+    if(!fHasResults)
+      return;
+    for(int i = 0; i < kRunCount; i++)
+      ImGui::Text("%d thread(s): %.3f ms/frame (x%.2f)", kThreadCounts[i], fResultsMs[i], fResultsMs[0] / fResultsMs[i]);
+  }
+
+  int fRun{-1};
+  int fFrame{};
+  double fAccumulatedMs{};
+  double fResultsMs[kRunCount]{};
+  bool fHasResults{};
+};
+
+static void glfw_error_callback(int error, const char *description)
+{
+  fprintf(stderr, "GLFW Error %d: %s\n", error, description);
+}
+
+// Main code
+int main(int, char **)
+{
+  glfwSetErrorCallback(glfw_error_callback);
+  if(!glfwInit())
+    return 1;
+
+  printf("Emscripten: %d.%d.%d\n", __EMSCRIPTEN_MAJOR__, __EMSCRIPTEN_MINOR__, __EMSCRIPTEN_TINY__);
+  printf("GLFW: %s\n", glfwGetVersionString());
+  printf("ImGui: %s\n", IMGUI_VERSION);
+
+  // Decide GL+GLSL versions
+  // GL ES 2.0 + GLSL 100
+  const char* glsl_version = "#version 100";
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+  glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_ES_API);
+
+  float main_scale = ImGui_ImplGlfw_GetContentScaleForMonitor(glfwGetPrimaryMonitor()); // Valid on GLFW 3.3+ only
+
+  // Create window with graphics context
+  GLFWwindow *window = glfwCreateWindow(1280, 720, "Dear ImGui GLFW+OpenGL3 (multi-threaded) example", nullptr, nullptr);
+  if(window == nullptr)
+    return 1;
+  glfwMakeContextCurrent(window);
+
+  // Setup Dear ImGui context
+  IMGUI_CHECKVERSION();
+  ImGui::CreateContext();
+  ImGuiIO &io = ImGui::GetIO();
+  (void) io;
+  io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;     // Enable Keyboard Controls
+  io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;      // Enable Gamepad Controls
+
+#ifdef IMGUI_ENABLE_DOCKING
+  io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
+  io.ConfigDockingWithShift = false;
+#endif
+
+  // Setup Dear ImGui style
+  ImGui::StyleColorsDark();
+  //ImGui::StyleColorsLight();
+
+  // Setup scaling
+  ImGuiStyle &style = ImGui::GetStyle();
+  style.ScaleAllSizes(main_scale);        // Bake a fixed style scale. (until we have a solution for dynamic style scaling, changing this requires resetting Style + calling this again)
+  style.FontScaleDpi = main_scale;        // Set initial font scale. (using io.ConfigDpiScaleFonts=true makes this unnecessary. We leave both here for documentation purpose)
+
+  // Setup Platform/Renderer backends
+  ImGui_ImplGlfw_InitForOpenGL(window, true);
+  // makes the canvas resizable and match the full window size
+  emscripten_glfw_make_canvas_resizable(window, "window", nullptr);
+  ImGui_ImplOpenGL3_Init(glsl_version);
+
+  // Our state
+  bool show_demo_window = true;
+  bool show_another_window = false;
+  bool show_frame_stats = false;
+  ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
+
+  // no filesystem access with emscripten
+  io.IniFilename = nullptr;
+
+  // Parallel geometry state
+  int thread_count = std::clamp(emscripten_num_logical_cores(), 1, 4);
+  int point_count = 200000;
+  int plot_count = 4;
+  double build_ms = 0;
+  ScalingBenchmark benchmark{};
+  auto parallel = std::make_unique<ParallelDrawLists>(thread_count);
+
+  App app{};
+  app.renderFrame = [&]() {
+    gFrameStats.beginFrame();
+
+    // Poll and handle events (inputs, window resize, etc.)
+    // You can read the io.WantCaptureMouse, io.WantCaptureKeyboard flags to tell if dear imgui wants to use your inputs.
+    // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application, or clear/overwrite your copy of the mouse data.
+    // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application, or clear/overwrite your copy of the keyboard data.
+    // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
+    glfwPollEvents();
+    gFrameStats.mark(FramePhase::PollEvents);
+
+    // Start the Dear ImGui frame
+    ImGui_ImplOpenGL3_NewFrame();
+    ImGui_ImplGlfw_NewFrame();
+    ImGui::NewFrame();
+    gFrameStats.mark(FramePhase::NewFrame);
+
+#ifdef IMGUI_ENABLE_DOCKING
+    ImGui::DockSpaceOverViewport(ImGui::GetMainViewport()->ID);
+#endif
+
+#ifndef IMGUI_DISABLE_DEMO
+    // 1. Show the big demo window (Most of the sample code is in ImGui::ShowDemoWindow()! You can browse its code to learn more about Dear ImGui!).
+    if(show_demo_window)
+      ImGui::ShowDemoWindow(&show_demo_window);
+#endif
+
+    // 2. Show a simple window that we create ourselves. We use a Begin/End pair to create a named window.
+    {
+      static float f = 0.0f;
+      static int counter = 0;
+
+      ImGui::Begin(
+        "Hello, world!");                          // Create a window called "Hello, world!" and append into it.
+
+      ImGui::Text("This is some useful text.");               // Display some text (you can use a format strings too)
+      ImGui::Checkbox("Demo Window", &show_demo_window);      // Edit bools storing our window open/close state
+      ImGui::Checkbox("Another Window", &show_another_window);
+      ImGui::Checkbox("Frame stats", &show_frame_stats);
+
+      ImGui::SliderFloat("float", &f, 0.0f, 1.0f);            // Edit 1 float using a slider from 0.0f to 1.0f
+      ImGui::ColorEdit3("clear color", (float *) &clear_color); // Edit 3 floats representing a color
+
+      if(ImGui::Button(
+        "Button"))                            // Buttons return true when clicked (most widgets return true when edited/activated)
+        counter++;
+      ImGui::SameLine();
+      ImGui::Text("counter = %d", counter);
+
+      if(ImGui::Button("Exit"))
+        glfwSetWindowShouldClose(window, GLFW_TRUE);
+
+      ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / io.Framerate, io.Framerate);
+      ImGui::End();
+    }
+
+    // 3. Show another simple window.
+    if(show_another_window)
+    {
+      ImGui::Begin("Another Window",
+                   &show_another_window);   // Pass a pointer to our bool variable (the window will have a closing button that will clear the bool when clicked)
+      ImGui::Text("Hello from another window!");
+      if(ImGui::Button("Close Me"))
+        show_another_window = false;
+      ImGui::End();
+    }
+
+    // 4. Show a window with large plots which geometry is generated in parallel
+    {
+      parallel->setThreadCount(benchmark.isRunning() ? benchmark.getThreadCount() : thread_count);
+
+      ImGui::Begin("Parallel plots");
+      ImGui::BeginDisabled(benchmark.isRunning());
+      ImGui::SliderInt("threads", &thread_count, 1, kMaxThreadCount);
+      ImGui::SliderInt("points per plot", &point_count, 1000, 1000000, "%d", ImGuiSliderFlags_Logarithmic);
+      ImGui::SliderInt("plots", &plot_count, 1, 16);
+      if(ImGui::Button("Run scaling benchmark"))
+        benchmark.start();
+      ImGui::EndDisabled();
+      ImGui::Text("Geometry built in %.3f ms (%d jobs, %d threads)", build_ms, parallel->getJobCount(),
+                  parallel->getThreadCount());
+      benchmark.renderResults();
+
+      auto time = static_cast<float>(ImGui::GetTime());
+      auto size = ImVec2(ImGui::GetContentRegionAvail().x, 120.0f * main_scale);
+      for(int plot = 0; plot < plot_count; plot++)
+      {
+        auto min = ImGui::GetCursorScreenPos();
+        auto max = ImVec2(min.x + size.x, min.y + size.y);
+        ImGui::Dummy(size);
+        if(!ImGui::IsItemVisible())
+          continue;
+        ImGui::GetWindowDrawList()->AddRectFilled(min, max, IM_COL32(30, 30, 30, 255));
+        for(int first = 0; first < point_count - 1; first += kPointsPerJob)
+        {
+          // chunks share their boundary point so that the polyline is continuous
+          auto last = std::min(first + kPointsPerJob, point_count - 1);
+          parallel->submit([=](ImDrawList *iDrawList) {
+            DrawPlotChunk(iDrawList, min, max, plot, first, last, point_count, time);
+          });
+        }
+      }
+      ImGui::End();
+    }
+
+    // Build the geometry (in parallel) once the UI is built and before rendering
+    auto build_start = emscripten_get_now();
+    parallel->build();
+    build_ms = emscripten_get_now() - build_start;
+    if(benchmark.isRunning())
+      benchmark.recordFrame(build_ms);
+
+    // 5. Show the frame stats overlay
+    if(show_frame_stats)
+      gFrameStats.renderOverlay(&show_frame_stats);
+    gFrameStats.mark(FramePhase::BuildUI);
+
+    // Rendering
+    ImGui::Render();
+    parallel->splice(ImGui::GetDrawData());
+    gFrameStats.mark(FramePhase::Render);
+    int display_w, display_h;
+    glfwGetFramebufferSize(window, &display_w, &display_h);
+    glViewport(0, 0, display_w, display_h);
+    glClearColor(clear_color.x * clear_color.w, clear_color.y * clear_color.w, clear_color.z * clear_color.w,
+                 clear_color.w);
+    glClear(GL_COLOR_BUFFER_BIT);
+    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    gFrameStats.mark(FramePhase::RenderDrawData);
+    // nothing to submit: the browser presents the canvas when the frame returns
+    gFrameStats.mark(FramePhase::Submit);
+    gFrameStats.endFrame(ImGui::GetDrawData());
+
+    return glfwWindowShouldClose(window);
+  };
+
+  app.cleanup = [window, &parallel]() {
+    // must be destroyed before the ImGui context
+    parallel.reset();
+
+    ImGui_ImplOpenGL3_Shutdown();
+    ImGui_ImplGlfw_Shutdown();
+    ImGui::DestroyContext();
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+  };
+
+  emscripten_set_main_loop_arg(MainLoopForEmscripten, &app, 0, true);
+
+  return 0;
+}
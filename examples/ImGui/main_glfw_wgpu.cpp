@@ -11,6 +11,15 @@
 #include <imgui.h>
 #include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_wgpu.h>
+#ifdef IMGUI_IMPL_WGPU_RING
+#include <imgui_impl_wgpu_ring.h>
+#endif
+#ifdef IMGUI_BAKED_FONTS
+#include <imgui_baked_fonts.h>
+#endif
+#ifdef IMGUI_LAZY_DEMO
+#include <imgui_lazy_demo.h>
+#endif
 #include <stdio.h>
 #include <emscripten/version.h>
 #include <emscripten.h>
@@ -20,6 +29,10 @@
 #include <webgpu/webgpu.h>
 #include <webgpu/webgpu_cpp.h>
 #include <functional>
+#include "app.h"
+#include "surface_resizer.h"
+#include "input_coalescer.h"
+#include "ini_storage.h"
 
 // Global WebGPU required states
 static WGPUInstance wgpu_instance = nullptr;
@@ -29,9 +42,13 @@ static WGPUQueue wgpu_queue = nullptr;
 static WGPUSurfaceConfiguration wgpu_surface_configuration = {};
 static int wgpu_surface_width = 1280;
 static int wgpu_surface_height = 800;
+static SurfaceResizer surface_resizer;
+static InputCoalescer input_coalescer;
+static IniStorage ini_storage{"/imgui/glfw_wgpu.ini"};
 
 // Forward declarations
-static bool InitWGPU();
+static void InitWGPU(std::function<void()> onReady, std::function<void()> onError);
+static void StartMainLoop(GLFWwindow *window);
 
 static WGPUSurface CreateWGPUSurface(const WGPUInstance &instance, GLFWwindow *window);
 
@@ -47,26 +64,25 @@ static void ResizeSurface(int width, int height)
   wgpuSurfaceConfigure(wgpu_surface, &wgpu_surface_configuration);
 }
 
-struct App
-{
-  std::function<bool()> renderFrame{};
-  std::function<void()> cleanup{};
-};
+// Time to first frame (from main() to the end of the first rendered frame)
+static double kStartTime = 0;
+static bool kFirstFrameRendered = false;
 
-static void MainLoopForEmscripten(void *iUserData)
+// The main loop starts when both the WebGPU device (requested asynchronously) and the ImGui setup (done while the
+// device request is pending) are ready
+static int kPendingInitSteps = 2;
+
+static void OnInitStepDone(GLFWwindow *window)
 {
-  auto app = reinterpret_cast<App *>(iUserData);
-  if(app->renderFrame())
-  {
-    if(app->cleanup)
-      app->cleanup();
-    emscripten_cancel_main_loop();
-  }
+  if(--kPendingInitSteps == 0)
+    StartMainLoop(window);
 }
 
 // Main code
 int main(int, char **)
 {
+  kStartTime = emscripten_get_now();
+
   glfwSetErrorCallback(glfw_error_callback);
   if(!glfwInit())
     return 1;
@@ -75,6 +91,9 @@ int main(int, char **)
   printf("GLFW: %s\n", glfwGetVersionString());
   printf("ImGui: %s\n", IMGUI_VERSION);
 
+  // starts loading the ImGui settings from IndexedDB while WebGPU is initialized (see ini_storage.h)
+  ini_storage.load();
+
   // Make sure GLFW does not initialize any graphics context.
   // This needs to be done explicitly later.
   glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
@@ -85,13 +104,16 @@ int main(int, char **)
   if(window == nullptr)
     return 1;
 
-  // Initialize the WebGPU environment
-  if(!InitWGPU())
-  {
-    glfwDestroyWindow(window);
-    glfwTerminate();
-    return 1;
-  }
+  // Initialize the WebGPU environment: the adapter/device requests are asynchronous (no need for ASYNCIFY), the
+  // rest of the initialization below happens while they are pending
+  InitWGPU([window]() { OnInitStepDone(window); },
+           [window]() {
+             printf("Failed to initialize WebGPU\n");
+             ImGui_ImplGlfw_Shutdown();
+             ImGui::DestroyContext();
+             glfwDestroyWindow(window);
+             glfwTerminate();
+           });
   glfwShowWindow(window);
 
   // Setup Dear ImGui context
@@ -116,10 +138,32 @@ int main(int, char **)
   style.ScaleAllSizes(main_scale);        // Bake a fixed style scale. (until we have a solution for dynamic style scaling, changing this requires resetting Style + calling this again)
   style.FontScaleDpi = main_scale;        // Set initial font scale. (using io.ConfigDpiScaleFonts=true makes this unnecessary. We leave both here for documentation purpose)
 
+#ifdef IMGUI_BAKED_FONTS
+  // the glyphs baked at build time (bakedFonts port option) are copied into the atlas instead of being rasterized
+  ImGui_BakedFonts_Install(io.Fonts);
+#endif
+
   // Setup Platform/Renderer backends
   ImGui_ImplGlfw_InitForOther(window, true);
-  // makes the canvas resizable and match the full window size
+  // makes the canvas resizable and match the full window size (emscripten-glfw resizes the canvas backing store on
+  // every resize event: SurfaceResizer only defers the surface configuration, see surface_resizer.h)
   emscripten_glfw_make_canvas_resizable(window, "window", nullptr);
+
+  // imgui.ini is not written by ImGui (the file system is in memory): the settings are loaded with
+  // LoadIniSettingsFromMemory() and persisted in IndexedDB by ini_storage
+  io.IniFilename = nullptr;
+
+  // Load the font (the atlas is then built on the first frame)
+  io.Fonts->AddFontDefault();
+
+  OnInitStepDone(window);
+
+  return 0;
+}
+
+// Second part of the initialization, once the WebGPU device is available
+static void StartMainLoop(GLFWwindow *window)
+{
   ImGui_ImplWGPU_InitInfo init_info;
   init_info.Device = wgpu_device;
   init_info.NumFramesInFlight = 3;
@@ -127,18 +171,33 @@ int main(int, char **)
   init_info.DepthStencilFormat = WGPUTextureFormat_Undefined;
   ImGui_ImplWGPU_Init(&init_info);
 
-  // Our state
-  bool show_demo_window = true;
-  bool show_another_window = false;
-  ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
+  // Our state (static: the main loop outlives this function)
+  static bool show_demo_window = true;
+  static bool show_another_window = false;
+  static ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
 
-  // For an Emscripten build we are disabling file-system access, so let's not attempt to do a fopen() of the imgui.ini file.
-  // You may manually call LoadIniSettingsFromMemory() to load settings from your own storage.
-  io.IniFilename = nullptr;
+  // Render pass descriptor (built once, only the view and clear color change every frame)
+  static WGPURenderPassColorAttachment color_attachments = {};
+  color_attachments.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
+  color_attachments.loadOp = WGPULoadOp_Clear;
+  color_attachments.storeOp = WGPUStoreOp_Store;
+
+  static WGPURenderPassDescriptor render_pass_desc = {};
+  render_pass_desc.colorAttachmentCount = 1;
+  render_pass_desc.colorAttachments = &color_attachments;
+  render_pass_desc.depthStencilAttachment = nullptr;
 
   // Main loop
-  App app{};
-  app.renderFrame = [&]() {
+  static App app{};
+  app.renderFrame = [window]() {
+    ImGuiIO &io = ImGui::GetIO();
+    // the first frame waits for the settings (loaded asynchronously from IndexedDB, see ini_storage.h)
+    if(!ini_storage.ready())
+    {
+      app.invalidate();
+      return false;
+    }
+
     // Poll and handle events (inputs, window resize, etc.)
     // You can read the io.WantCaptureMouse, io.WantCaptureKeyboard flags to tell if dear imgui wants to use your inputs.
     // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application, or clear/overwrite your copy of the mouse data.
@@ -146,11 +205,18 @@ int main(int, char **)
     // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
     glfwPollEvents();
 
-    // React to changes in screen size
-    int width, height;
-    glfwGetFramebufferSize((GLFWwindow *) window, &width, &height);
-    if(width != wgpu_surface_width || height != wgpu_surface_height)
-      ResizeSurface(width, height);
+    // React to changes in screen size: the surface is reconfigured once the size has settled (not on every frame
+    // of a window drag)
+    int width, height, fb_width, fb_height;
+    glfwGetWindowSize((GLFWwindow *) window, &width, &height);
+    glfwGetFramebufferSize((GLFWwindow *) window, &fb_width, &fb_height);
+    float pixel_ratio = width > 0 ? static_cast<float>(fb_width) / width : 1.0f;
+    if(surface_resizer.update(width, height, pixel_ratio, emscripten_get_now()))
+      ResizeSurface(surface_resizer.width, surface_resizer.height);
+    if(surface_resizer.pending)
+      app.invalidate(); // keeps the main loop running until the size settles
+    if(surface_resizer.configurations == 0)
+      return false; // the canvas is not laid out yet
 
     // Check surface status for error. If texture is not optimal, try to reconfigure the surface.
     WGPUSurfaceTexture surface_texture;
@@ -164,15 +230,23 @@ int main(int, char **)
     {
       if(surface_texture.texture)
         wgpuTextureRelease(surface_texture.texture);
-      if(width > 0 && height > 0)
-        ResizeSurface(width, height);
+      ResizeSurface(surface_resizer.width, surface_resizer.height);
       return false;
     }
 
     // Start the Dear ImGui frame
     ImGui_ImplWGPU_NewFrame();
     ImGui_ImplGlfw_NewFrame();
+    // the surface may not have the size of the framebuffer (capped pixel ratio): the scissor rectangles must match
+    // the surface (while a resize is pending, the browser has already resized the canvas to the framebuffer size)
+    if(!surface_resizer.pending)
+      io.DisplayFramebufferScale = ImVec2(surface_resizer.scaleX, surface_resizer.scaleY);
+    // merges the mouse move/wheel events queued since the previous frame (see input_coalescer.h)
+    input_coalescer.coalesce();
     ImGui::NewFrame();
+    // saves the settings when they change (written to IndexedDB in the background)
+    if(ini_storage.update())
+      app.invalidate();
 
 #ifdef IMGUI_ENABLE_DOCKING
     ImGui::DockSpaceOverViewport(ImGui::GetMainViewport()->ID);
@@ -181,8 +255,17 @@ int main(int, char **)
 #ifndef IMGUI_DISABLE_DEMO
     // 1. Show the big demo window (Most of the sample code is in ImGui::ShowDemoWindow()! You can browse its code to learn more about Dear ImGui!).
     if(show_demo_window)
+    {
+#ifdef IMGUI_LAZY_DEMO
+      // the demo is fetched (imgui_demo.wasm) the first time it is shown (see imgui_lazy_demo.h)
+      ImGui_LazyDemo_ShowDemoWindow(&show_demo_window);
+      if(ImGui_LazyDemo_GetStatus() == ImGui_LazyDemo_Status_Loading)
+        app.invalidate(); // keeps the main loop running until the demo is loaded
+#else
       ImGui::ShowDemoWindow(&show_demo_window);
 #endif
+    }
+#endif
 
     // 2. Show a simple window that we create ourselves. We use a Begin/End pair to create a named window.
     {
@@ -221,46 +304,42 @@ int main(int, char **)
       ImGui::End();
     }
 
+#ifdef IMGUI_IMPL_WGPU_RING
+    // the texture updates are uploaded within a budget of bytes per frame: keeps the main loop running until the
+    // deferred ones are uploaded (see imgui_impl_wgpu_ring.h)
+    if(ImGui_ImplWGPURing_GetStats().TexturePendingBytes > 0)
+      app.invalidate();
+#endif
+
     // Rendering
     ImGui::Render();
 
-    WGPUTextureViewDescriptor view_desc = {};
-    view_desc.format = wgpu_surface_configuration.format;
-    view_desc.dimension = WGPUTextureViewDimension_2D;
-    view_desc.mipLevelCount = WGPU_MIP_LEVEL_COUNT_UNDEFINED;
-    view_desc.arrayLayerCount = WGPU_ARRAY_LAYER_COUNT_UNDEFINED;
-    view_desc.aspect = WGPUTextureAspect_All;
-
-    WGPUTextureView texture_view = wgpuTextureCreateView(surface_texture.texture, &view_desc);
-
-    WGPURenderPassColorAttachment color_attachments = {};
-    color_attachments.depthSlice = WGPU_DEPTH_SLICE_UNDEFINED;
-    color_attachments.loadOp = WGPULoadOp_Clear;
-    color_attachments.storeOp = WGPUStoreOp_Store;
+    // default view (same format as the surface) and pre-built descriptors: no descriptor to marshal to javascript
+    WGPUTextureView texture_view = wgpuTextureCreateView(surface_texture.texture, nullptr);
     color_attachments.clearValue = {clear_color.x * clear_color.w, clear_color.y * clear_color.w,
                                     clear_color.z * clear_color.w, clear_color.w};
     color_attachments.view = texture_view;
 
-    WGPURenderPassDescriptor render_pass_desc = {};
-    render_pass_desc.colorAttachmentCount = 1;
-    render_pass_desc.colorAttachments = &color_attachments;
-    render_pass_desc.depthStencilAttachment = nullptr;
-
-    WGPUCommandEncoderDescriptor enc_desc = {};
-    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(wgpu_device, &enc_desc);
+    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(wgpu_device, nullptr);
 
     WGPURenderPassEncoder pass = wgpuCommandEncoderBeginRenderPass(encoder, &render_pass_desc);
     ImGui_ImplWGPU_RenderDrawData(ImGui::GetDrawData(), pass);
     wgpuRenderPassEncoderEnd(pass);
 
-    WGPUCommandBufferDescriptor cmd_buffer_desc = {};
-    WGPUCommandBuffer cmd_buffer = wgpuCommandEncoderFinish(encoder, &cmd_buffer_desc);
+    WGPUCommandBuffer cmd_buffer = wgpuCommandEncoderFinish(encoder, nullptr);
     wgpuQueueSubmit(wgpu_queue, 1, &cmd_buffer);
 
     wgpuTextureViewRelease(texture_view);
     wgpuRenderPassEncoderRelease(pass);
     wgpuCommandEncoderRelease(encoder);
     wgpuCommandBufferRelease(cmd_buffer);
+    wgpuTextureRelease(surface_texture.texture);
+
+    if(!kFirstFrameRendered)
+    {
+      kFirstFrameRendered = true;
+      printf("Time to first frame: %.1fms\n", emscripten_get_now() - kStartTime);
+    }
 
     return glfwWindowShouldClose(window) == GLFW_TRUE;
   };
@@ -280,77 +359,16 @@ int main(int, char **)
     glfwTerminate();
   };
 
-  emscripten_set_main_loop_arg(MainLoopForEmscripten, &app, 0, true);
-
-  return 0;
-}
-
-static WGPUAdapter RequestAdapter(wgpu::Instance &instance)
-{
-  wgpu::Adapter acquired_adapter;
-  wgpu::RequestAdapterOptions adapter_options;
-  auto onRequestAdapter = [&](wgpu::RequestAdapterStatus status, wgpu::Adapter adapter, wgpu::StringView message) {
-    if(status != wgpu::RequestAdapterStatus::Success)
-    {
-      printf("Failed to get an adapter: %s\n", message.data);
-      return;
-    }
-    acquired_adapter = std::move(adapter);
-  };
+  // suspends the main loop while the application is idle (no input, resize, ...)
+  app.eventDriven = true;
 
-  wgpu::Future waitAdapterFunc { instance.RequestAdapter(&adapter_options, wgpu::CallbackMode::WaitAnyOnly, onRequestAdapter) };
-  // This synchronous call requires the "-s ASYNCIFY=1" option when compiling this example
-  wgpu::WaitStatus waitStatusAdapter = instance.WaitAny(waitAdapterFunc, UINT64_MAX);
-  IM_ASSERT(acquired_adapter != nullptr && waitStatusAdapter == wgpu::WaitStatus::Success && "Error on Adapter request");
-  return acquired_adapter.MoveToCHandle();
+  emscripten_set_main_loop_arg(MainLoopForEmscripten, &app, 0, false);
 }
 
-static WGPUDevice RequestDevice(wgpu::Instance& instance, wgpu::Adapter& adapter)
-{
-  // Set device callback functions
-  wgpu::DeviceDescriptor device_desc;
-  device_desc.SetDeviceLostCallback(wgpu::CallbackMode::AllowSpontaneous,
-                                    [](const wgpu::Device&, wgpu::DeviceLostReason type, wgpu::StringView msg) {
-                                      fprintf(stderr, "%s error: %s\n", ImGui_ImplWGPU_GetDeviceLostReasonName((WGPUDeviceLostReason)type), msg.data);
-                                    }
-  );
-  device_desc.SetUncapturedErrorCallback([](const wgpu::Device&, wgpu::ErrorType type, wgpu::StringView msg) {
-    fprintf(stderr, "%s error: %s\n", ImGui_ImplWGPU_GetErrorTypeName((WGPUErrorType)type), msg.data); }
-  );
-
-  wgpu::Device acquired_device;
-  auto onRequestDevice = [&](wgpu::RequestDeviceStatus status, wgpu::Device local_device, wgpu::StringView message) {
-    if (status != wgpu::RequestDeviceStatus::Success)
-    {
-      printf("Failed to get an device: %s\n", message.data);
-      return;
-    }
-    acquired_device = std::move(local_device);
-  };
-
-  // Synchronously (wait until) get Device
-  wgpu::Future waitDeviceFunc { adapter.RequestDevice(&device_desc, wgpu::CallbackMode::WaitAnyOnly, onRequestDevice) };
-  // This synchronous call requires the "-s ASYNCIFY=1" option when compiling this example
-  wgpu::WaitStatus waitStatusDevice = instance.WaitAny(waitDeviceFunc, UINT64_MAX);
-  IM_ASSERT(acquired_device != nullptr && waitStatusDevice == wgpu::WaitStatus::Success && "Error on Device request");
-  return acquired_device.MoveToCHandle();
-}
-
-static bool InitWGPU()
+static bool ConfigureSurface(const wgpu::Instance &instance, const wgpu::Adapter &adapter)
 {
   WGPUTextureFormat preferred_fmt = WGPUTextureFormat_Undefined;
 
-  wgpu::InstanceDescriptor instance_desc = {};
-  static constexpr wgpu::InstanceFeatureName timedWaitAny = wgpu::InstanceFeatureName::TimedWaitAny;
-  instance_desc.requiredFeatureCount = 1;
-  instance_desc.requiredFeatures = &timedWaitAny;
-  wgpu::Instance instance = wgpu::CreateInstance(&instance_desc);
-
-  wgpu::Adapter adapter = RequestAdapter(instance);
-  ImGui_ImplWGPU_DebugPrintAdapterInfo(adapter.Get());
-
-  wgpu_device = RequestDevice(instance, adapter);
-
   wgpu::EmscriptenSurfaceSourceCanvasHTMLSelector canvas_desc = {};
   canvas_desc.selector = "#canvas";
 
@@ -361,7 +379,8 @@ static bool InitWGPU()
   if(!wgpu_surface)
     return false;
 
-  wgpu_instance = instance.MoveToCHandle();
+  wgpu_instance = instance.Get();
+  wgpuInstanceAddRef(wgpu_instance);
 
   WGPUSurfaceCapabilities surface_capabilities = {};
   wgpuSurfaceGetCapabilities(wgpu_surface, adapter.Get(), &surface_capabilities);
@@ -376,8 +395,59 @@ static bool InitWGPU()
   wgpu_surface_configuration.device = wgpu_device;
   wgpu_surface_configuration.format = preferred_fmt;
 
-  wgpuSurfaceConfigure(wgpu_surface, &wgpu_surface_configuration);
+  // the surface is configured by the first frame, with the size of the canvas (see SurfaceResizer)
+  WGPULimits limits = {};
+  if(wgpuDeviceGetLimits(wgpu_device, &limits) == WGPUStatus_Success)
+    surface_resizer.maxDimension = static_cast<int>(limits.maxTextureDimension2D);
   wgpu_queue = wgpuDeviceGetQueue(wgpu_device);
 
   return true;
 }
+
+// Requests the adapter, then the device, then configures the surface. Each step continues in the callback of the
+// previous one (CallbackMode::AllowSpontaneous: the callbacks are invoked from the browser event loop), so nothing
+// blocks and the example does not require ASYNCIFY.
+static void InitWGPU(std::function<void()> onReady, std::function<void()> onError)
+{
+  wgpu::Instance instance = wgpu::CreateInstance();
+
+  wgpu::RequestAdapterOptions adapter_options;
+  instance.RequestAdapter(&adapter_options, wgpu::CallbackMode::AllowSpontaneous,
+                          [instance, onReady, onError](wgpu::RequestAdapterStatus status, wgpu::Adapter adapter, wgpu::StringView message) {
+                            if(status != wgpu::RequestAdapterStatus::Success)
+                            {
+                              printf("Failed to get an adapter: %.*s\n", (int) message.length, message.data);
+                              onError();
+                              return;
+                            }
+                            ImGui_ImplWGPU_DebugPrintAdapterInfo(adapter.Get());
+
+                            // Set device callback functions
+                            wgpu::DeviceDescriptor device_desc;
+                            device_desc.SetDeviceLostCallback(wgpu::CallbackMode::AllowSpontaneous,
+                                                              [](const wgpu::Device&, wgpu::DeviceLostReason type, wgpu::StringView msg) {
+                                                                fprintf(stderr, "%s error: %s\n", ImGui_ImplWGPU_GetDeviceLostReasonName((WGPUDeviceLostReason)type), msg.data);
+                                                              }
+                            );
+                            device_desc.SetUncapturedErrorCallback([](const wgpu::Device&, wgpu::ErrorType type, wgpu::StringView msg) {
+                              fprintf(stderr, "%s error: %s\n", ImGui_ImplWGPU_GetErrorTypeName((WGPUErrorType)type), msg.data); }
+                            );
+
+                            adapter.RequestDevice(&device_desc, wgpu::CallbackMode::AllowSpontaneous,
+                                                  [instance, adapter, onReady, onError](wgpu::RequestDeviceStatus status, wgpu::Device device, wgpu::StringView message) {
+                                                    if(status != wgpu::RequestDeviceStatus::Success)
+                                                    {
+                                                      printf("Failed to get an device: %.*s\n", (int) message.length, message.data);
+                                                      onError();
+                                                      return;
+                                                    }
+                                                    wgpu_device = device.MoveToCHandle();
+                                                    if(!ConfigureSurface(instance, adapter))
+                                                    {
+                                                      onError();
+                                                      return;
+                                                    }
+                                                    onReady();
+                                                  });
+                          });
+}
@@ -0,0 +1,206 @@
+// Dear ImGui: example application rendering in a pthread (OffscreenCanvas + WebGL2), using the html5 API directly
+// (no GLFW/SDL backend: see html5_platform.h)
+//
+// Built with -sPROXY_TO_PTHREAD, main() (and so the whole ImGui frame: event processing, UI build and rendering)
+// runs in a pthread: a long frame no longer blocks the main browser thread (page scrolling, input, other DOM
+// updates). The canvas is transferred to the pthread (-sOFFSCREENCANVAS_SUPPORT), and the DOM events are forwarded
+// to it by the html5 API. Requires -pthread (and the threads=true port option).
+
+// Learn about Dear ImGui:
+// - FAQ                  https://dearimgui.com/faq
+// - Getting Started      https://dearimgui.com/getting-started
+// - Documentation        https://dearimgui.com/docs (same as your local docs/ folder).
+// - Introduction, links and more at the top of imgui.cpp
+
+#include <imgui.h>
+#include <backends/imgui_impl_opengl3.h>
+#ifdef IMGUI_IMPL_WEBGL2
+#include <imgui_impl_webgl2.h>
+#endif
+#include <stdio.h>
+#include <GLES2/gl2.h>
+#include <emscripten/version.h>
+#include <emscripten.h>
+#include <emscripten/html5.h>
+#include <emscripten/threading.h>
+#include "app.h"
+#include "frame_stats.h"
+#include "html5_platform.h"
+
+static Html5Platform kPlatform{};
+
+// Creates a WebGL2 context on the canvas transferred to this thread. If the browser does not support OffscreenCanvas,
+// falls back to proxying the GL calls to the main thread (-sOFFSCREEN_FRAMEBUFFER), which works but gives back most
+// of the benefit of this example.
+static EMSCRIPTEN_WEBGL_CONTEXT_HANDLE CreateContext(char const *iCanvasSelector)
+{
+  EmscriptenWebGLContextAttributes attributes;
+  emscripten_webgl_init_context_attributes(&attributes);
+  attributes.majorVersion = 2;
+  attributes.minorVersion = 0;
+  attributes.proxyContextToMainThread = EMSCRIPTEN_WEBGL_CONTEXT_PROXY_DISALLOW;
+  auto context = emscripten_webgl_create_context(iCanvasSelector, &attributes);
+  if(context > 0)
+  {
+    printf("WebGL2: rendering in the pthread (OffscreenCanvas)\n");
+    return context;
+  }
+
+  attributes.proxyContextToMainThread = EMSCRIPTEN_WEBGL_CONTEXT_PROXY_ALWAYS;
+  attributes.renderViaOffscreenBackBuffer = true;
+  context = emscripten_webgl_create_context(iCanvasSelector, &attributes);
+  if(context > 0)
+    printf("WebGL2: OffscreenCanvas not supported, GL calls are proxied to the main thread\n");
+  return context;
+}
+
+// Main code (runs in a pthread, see -sPROXY_TO_PTHREAD)
+int main(int, char **)
+{
+  printf("Emscripten: %d.%d.%d\n", __EMSCRIPTEN_MAJOR__, __EMSCRIPTEN_MINOR__, __EMSCRIPTEN_TINY__);
+  printf("ImGui: %s\n", IMGUI_VERSION);
+  printf("Main browser thread: %s\n", emscripten_is_main_browser_thread() ? "yes" : "no");
+
+  auto context = CreateContext("#canvas");
+  if(context <= 0)
+  {
+    printf("Error: could not create a WebGL2 context\n");
+    return 1;
+  }
+  emscripten_webgl_make_context_current(context);
+
+  // the input events handled by ImGui cannot be prevented by the pthread: the page does it (see shell.html)
+  MAIN_THREAD_EM_ASM({
+    if(Module['preventDefaultKeyActions'])
+      Module['preventDefaultKeyActions']();
+  });
+
+  // Setup Dear ImGui context
+  IMGUI_CHECKVERSION();
+  ImGui::CreateContext();
+  ImGuiIO &io = ImGui::GetIO();
+  (void) io;
+  io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;     // Enable Keyboard Controls
+
+#ifdef IMGUI_ENABLE_DOCKING
+  io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
+  io.ConfigDockingWithShift = false;
+#endif
+
+  // Setup Dear ImGui style
+  ImGui::StyleColorsDark();
+  //ImGui::StyleColorsLight();
+
+  // Setup Platform/Renderer backends
+  kPlatform.init("#canvas");
+  ImGui_ImplOpenGL3_Init("#version 300 es");
+#ifdef IMGUI_IMPL_WEBGL2
+  // the example only clears the framebuffer: no need to save/restore the GL state around ImGui
+  ImGui_ImplWebGL2_SetOwnsContext(true);
+#endif
+
+  // Our state
+  static bool show_demo_window = true;
+  static bool show_frame_stats = false;
+  static bool exit_requested = false;
+  static int long_frame_ms = 0;
+  static ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
+
+  // no filesystem access with emscripten
+  io.IniFilename = nullptr;
+
+  // static: the main loop outlives main()
+  static App app{};
+  app.renderFrame = []() {
+    ImGuiIO &io = ImGui::GetIO();
+    gFrameStats.beginFrame();
+
+    // the DOM events forwarded since the previous frame have already been processed (html5 callbacks)
+    gFrameStats.mark(FramePhase::PollEvents);
+
+    // Start the Dear ImGui frame
+    kPlatform.newFrame();
+    if(kPlatform.getFramebufferWidth() <= 0 || kPlatform.getFramebufferHeight() <= 0)
+      return false; // the canvas is not laid out yet
+    ImGui_ImplOpenGL3_NewFrame();
+    ImGui::NewFrame();
+    gFrameStats.mark(FramePhase::NewFrame);
+
+#ifdef IMGUI_ENABLE_DOCKING
+    ImGui::DockSpaceOverViewport(ImGui::GetMainViewport()->ID);
+#endif
+
+#ifndef IMGUI_DISABLE_DEMO
+    // 1. Show the big demo window (Most of the sample code is in ImGui::ShowDemoWindow()! You can browse its code to learn more about Dear ImGui!).
+    if(show_demo_window)
+      ImGui::ShowDemoWindow(&show_demo_window);
+#endif
+
+    // 2. Show a simple window that we create ourselves. We use a Begin/End pair to create a named window.
+    {
+      ImGui::Begin("Hello, world!");
+      ImGui::Text("ImGui runs in a pthread: the main browser thread stays free.");
+      ImGui::Checkbox("Demo Window", &show_demo_window);
+      ImGui::Checkbox("Frame stats", &show_frame_stats);
+      ImGui::ColorEdit3("clear color", (float *) &clear_color);
+
+      // simulates a data-heavy frame: only this thread is blocked, the page remains responsive
+      ImGui::SliderInt("Long frame (ms)", &long_frame_ms, 0, 500);
+
+      if(ImGui::Button("Exit"))
+        exit_requested = true;
+
+      ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / io.Framerate, io.Framerate);
+      ImGui::Text("Canvas %dx%d, %d DOM events forwarded", kPlatform.getFramebufferWidth(),
+                  kPlatform.getFramebufferHeight(), kPlatform.getEventCount());
+#ifdef IMGUI_IMPL_WEBGL2
+      // stats of the previous frame (the stock renderer issues 1 draw call and ~3 GL calls per ImDrawCmd)
+      auto webgl2_stats = ImGui_ImplWebGL2_GetStats();
+      ImGui::Text("webgl2: %d draw calls for %d ImDrawCmd", webgl2_stats.DrawCalls, webgl2_stats.DrawCommands);
+      ImGui::Text("webgl2: %d GL calls (%.1f KB uploaded)", webgl2_stats.GLCalls, webgl2_stats.UploadBytes / 1024.0f);
+#endif
+      ImGui::End();
+    }
+
+    // 3. Show the frame stats overlay
+    if(show_frame_stats)
+      gFrameStats.renderOverlay(&show_frame_stats);
+
+    if(long_frame_ms > 0)
+    {
+      auto end = emscripten_get_now() + long_frame_ms;
+      while(emscripten_get_now() < end)
+        ;
+    }
+    gFrameStats.mark(FramePhase::BuildUI);
+
+    // Rendering
+    ImGui::Render();
+    gFrameStats.mark(FramePhase::Render);
+    glViewport(0, 0, kPlatform.getFramebufferWidth(), kPlatform.getFramebufferHeight());
+    glClearColor(clear_color.x * clear_color.w, clear_color.y * clear_color.w, clear_color.z * clear_color.w,
+                 clear_color.w);
+    glClear(GL_COLOR_BUFFER_BIT);
+    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    gFrameStats.mark(FramePhase::RenderDrawData);
+    // nothing to submit: the OffscreenCanvas is presented when the frame returns
+    gFrameStats.mark(FramePhase::Submit);
+    gFrameStats.endFrame(ImGui::GetDrawData());
+
+    return exit_requested;
+  };
+
+  app.cleanup = [context]() {
+    ImGui_ImplOpenGL3_Shutdown();
+    kPlatform.shutdown();
+    ImGui::DestroyContext();
+    emscripten_webgl_destroy_context(context);
+  };
+
+  // the event-driven mode of App listens to the DOM, which is not accessible from a pthread: renders every frame
+  app.eventDriven = false;
+
+  emscripten_set_main_loop_arg(MainLoopForEmscripten, &app, 0, false);
+
+  return 0;
+}
@@ -10,9 +10,21 @@
 #include <imgui.h>
 #include <backends/imgui_impl_sdl2.h>
 #include <backends/imgui_impl_opengl3.h>
+#ifdef IMGUI_IMPL_WEBGL2
+#include <imgui_impl_webgl2.h>
+#endif
+#ifdef IMGUI_BAKED_FONTS
+#include <imgui_baked_fonts.h>
+#endif
+#ifdef IMGUI_LAZY_DEMO
+#include <imgui_lazy_demo.h>
+#endif
 #include <stdio.h>
 #include <SDL.h>
 #include <functional>
+#include "app.h"
+#include "input_coalescer.h"
+#include "ini_storage.h"
 #include <emscripten/emscripten.h>
 #include <emscripten/version.h>
 
@@ -24,23 +36,6 @@
 
 #endif
 
-struct App
-{
-  std::function<bool()> renderFrame{};
-  std::function<void()> cleanup{};
-};
-
-static void MainLoopForEmscripten(void *iUserData)
-{
-  auto app = reinterpret_cast<App *>(iUserData);
-  if(app->renderFrame())
-  {
-    if(app->cleanup)
-      app->cleanup();
-    emscripten_cancel_main_loop();
-  }
-}
-
 // Main code
 int main(int, char **)
 {
@@ -58,6 +53,10 @@ int main(int, char **)
   printf("SDL: %d.%d.%d\n", compiled.major, compiled.minor, compiled.patch);
   printf("ImGui: %s\n", IMGUI_VERSION);
 
+  // starts loading the ImGui settings from IndexedDB while the application is set up (see ini_storage.h)
+  IniStorage ini_storage{"/imgui/sdl2_opengl3.ini"};
+  ini_storage.load();
+
   // Decide GL+GLSL versions
 #if defined(IMGUI_IMPL_OPENGL_ES2)
   // GL ES 2.0 + GLSL 100
@@ -111,14 +110,25 @@ int main(int, char **)
   (void) io;
   io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;     // Enable Keyboard Controls
   io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;      // Enable Gamepad Controls
+  // imgui.ini is not written by ImGui (the file system is in memory): see ini_storage
+  io.IniFilename = nullptr;
 
   // Setup Dear ImGui style
   ImGui::StyleColorsDark();
   //ImGui::StyleColorsLight();
 
+#ifdef IMGUI_BAKED_FONTS
+  // the glyphs baked at build time (bakedFonts port option) are copied into the atlas instead of being rasterized
+  ImGui_BakedFonts_Install(io.Fonts);
+#endif
+
   // Setup Platform/Renderer backends
   ImGui_ImplSDL2_InitForOpenGL(window, gl_context);
   ImGui_ImplOpenGL3_Init(glsl_version);
+#ifdef IMGUI_IMPL_WEBGL2
+  // the example only clears the framebuffer: no need to save/restore the GL state around ImGui
+  ImGui_ImplWebGL2_SetOwnsContext(true);
+#endif
 
   // Load Fonts
   // - If no fonts are loaded, dear imgui will use the default font. You can also load multiple fonts and use ImGui::PushFont()/PopFont() to select them.
@@ -140,12 +150,20 @@ int main(int, char **)
   // Our state
   bool show_demo_window = true;
   bool show_another_window = false;
+  InputCoalescer input_coalescer{};
   ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
 
   // Main loop
   bool done = false;
   App app{};
   app.renderFrame = [&]() {
+    // the first frame waits for the settings (loaded asynchronously from IndexedDB, see ini_storage.h)
+    if(!ini_storage.ready())
+    {
+      app.invalidate();
+      return false;
+    }
+
     // Poll and handle events (inputs, window resize, etc.)
     // You can read the io.WantCaptureMouse, io.WantCaptureKeyboard flags to tell if dear imgui wants to use your inputs.
     // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application, or clear/overwrite your copy of the mouse data.
@@ -165,11 +183,25 @@ int main(int, char **)
     // Start the Dear ImGui frame
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplSDL2_NewFrame();
+    // merges the mouse move/wheel events queued since the previous frame (see input_coalescer.h)
+    input_coalescer.coalesce();
     ImGui::NewFrame();
+    // saves the settings when they change (written to IndexedDB in the background)
+    if(ini_storage.update())
+      app.invalidate();
 
     // 1. Show the big demo window (Most of the sample code is in ImGui::ShowDemoWindow()! You can browse its code to learn more about Dear ImGui!).
     if(show_demo_window)
+    {
+#ifdef IMGUI_LAZY_DEMO
+      // the demo is fetched (imgui_demo.wasm) the first time it is shown (see imgui_lazy_demo.h)
+      ImGui_LazyDemo_ShowDemoWindow(&show_demo_window);
+      if(ImGui_LazyDemo_GetStatus() == ImGui_LazyDemo_Status_Loading)
+        app.invalidate(); // keeps the main loop running until the demo is loaded
+#else
       ImGui::ShowDemoWindow(&show_demo_window);
+#endif
+    }
 
     // 2. Show a simple window that we create ourselves. We use a Begin/End pair to create a named window.
     {
@@ -210,6 +242,13 @@ int main(int, char **)
       ImGui::End();
     }
 
+#ifdef IMGUI_IMPL_WEBGL2
+    // the texture updates are uploaded within a budget of bytes per frame: keeps the main loop running until the
+    // deferred ones are uploaded (see imgui_impl_webgl2.h)
+    if(ImGui_ImplWebGL2_GetStats().TexturePendingBytes > 0)
+      app.invalidate();
+#endif
+
     // Rendering
     ImGui::Render();
     glViewport(0, 0, (int) io.DisplaySize.x, (int) io.DisplaySize.y);
@@ -233,6 +272,9 @@ int main(int, char **)
     SDL_Quit();
   };
 
+  // suspends the main loop while the application is idle (no input, resize, ...)
+  app.eventDriven = true;
+
   emscripten_set_main_loop_arg(MainLoopForEmscripten, &app, 0, true);
 
   return 0;
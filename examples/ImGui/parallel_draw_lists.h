@@ -0,0 +1,244 @@
+// Helper to build ImDrawList geometry in parallel on a pool of worker threads (requires -pthread)
+//
+// Usage (main thread):
+// - ImGui::NewFrame()
+// - ... build the UI, calling submit() from within a window (the job draws on top of the window content, clipped
+//       by the window current clip rect)
+// - build()                        : runs all submitted jobs in parallel and waits for completion
+// - ImGui::Render()
+// - splice(ImGui::GetDrawData())   : inserts the draw lists right after the draw list of the window they were
+//                                    submitted from (which preserves z-order)
+// - ImGui_ImplXXX_RenderDrawData(ImGui::GetDrawData())
+//
+// Notes:
+// - build() must be called after the UI is built: while jobs are running, the main thread must not emit any text
+//   (the font atlas may be updated when new glyphs are rendered)
+// - jobs must only use geometry primitives (no AddText) for the same reason
+// - each job draws with its own copy of the shared draw list data (taken when submitted): the anti-aliased
+//   primitives use its temporary buffer, which cannot be shared between threads
+// - with 16-bit indices (the default ImDrawIdx), each job must generate less than 64k vertices, so split large
+//   data sets into several jobs
+// - the instance must be destroyed before ImGui::DestroyContext()
+
+#pragma once
+
+#include <imgui.h>
+#include <imgui_internal.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ParallelDrawLists
+{
+public:
+  using Job = std::function<void(ImDrawList *)>;
+
+  // iThreadCount includes the calling (main) thread, so 1 means no worker thread
+  explicit ParallelDrawLists(int iThreadCount) { startWorkers(iThreadCount - 1); }
+  ~ParallelDrawLists() { stopWorkers(); }
+
+  int getThreadCount() const { return static_cast<int>(fWorkers.size()) + 1; }
+
+  void setThreadCount(int iThreadCount)
+  {
+    if(iThreadCount != getThreadCount())
+    {
+      stopWorkers();
+      startWorkers(iThreadCount - 1);
+    }
+  }
+
+  int getJobCount() const { return fJobCount; }
+
+  // Adds a job drawing into the current window (must be called between ImGui::Begin/ImGui::End)
+  void submit(Job iJob)
+  {
+    auto host = ImGui::GetWindowDrawList();
+    if(fJobCount == static_cast<int>(fEntries.size()))
+      fEntries.emplace_back(std::make_unique<Entry>());
+    auto &entry = *fEntries[fJobCount++];
+    entry.fHost = host;
+    entry.fJob = std::move(iJob);
+    entry.copySharedData(*ImGui::GetDrawListSharedData());
+    entry.fDrawList._ResetForNewFrame();
+    entry.fDrawList.Flags = host->Flags; // anti-aliasing, as configured by the style
+    entry.fDrawList.PushTexture(ImGui::GetIO().Fonts->TexRef);
+    entry.fDrawList.PushClipRect(host->GetClipRectMin(), host->GetClipRectMax());
+  }
+
+  // Runs all submitted jobs (the calling thread participates) and returns when they are all completed
+  void build()
+  {
+    if(fJobCount == 0)
+      return;
+
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      // a worker may still be returning from the previous generation
+      fWorkDone.wait(lock, [this] { return fActiveWorkers == 0; });
+      fNextJob = 0;
+      fPendingJobs = fJobCount;
+      fBuildJobCount = fJobCount;
+      fGeneration++;
+    }
+    fWorkAvailable.notify_all();
+
+    runJobs(fJobCount);
+
+    std::unique_lock<std::mutex> lock(fMutex);
+    fWorkDone.wait(lock, [this] { return fPendingJobs == 0 && fActiveWorkers == 0; });
+  }
+
+  // Inserts the draw lists built by the jobs in the draw data (must be called after ImGui::Render)
+  void splice(ImDrawData *iDrawData)
+  {
+    for(int i = 0; i < fJobCount; i++)
+    {
+      auto &entry = *fEntries[i];
+      auto list = &entry.fDrawList;
+      list->_PopUnusedDrawCmd();
+      if(list->CmdBuffer.Size == 0)
+        continue;
+      IM_ASSERT((sizeof(ImDrawIdx) == 4 || list->_VtxCurrentIdx < (1 << 16)) && "Too many vertices in a single job");
+
+      // insert after the host draw list and the lists previously inserted for the same host
+      auto &lists = iDrawData->CmdLists;
+      int position = lists.Size;
+      for(int j = 0; j < lists.Size; j++)
+      {
+        if(lists[j] == entry.fHost)
+        {
+          position = j + 1;
+          while(position < lists.Size && isSplicedFor(lists[position], entry.fHost))
+            position++;
+          break;
+        }
+      }
+      lists.insert(lists.Data + position, list);
+      iDrawData->CmdListsCount = lists.Size;
+      iDrawData->TotalVtxCount += list->VtxBuffer.Size;
+      iDrawData->TotalIdxCount += list->IdxBuffer.Size;
+    }
+    fJobCount = 0;
+  }
+
+private:
+  struct Entry
+  {
+    Entry() : fDrawList{&fSharedData} {}
+
+    // copies the shared data of the frame (font, tessellation, clip rect...) but keeps the temporary buffer and
+    // the draw lists registered with this copy
+    void copySharedData(ImDrawListSharedData const &iSharedData)
+    {
+      ImVector<ImVec2> tempBuffer;
+      ImVector<ImDrawList *> drawLists;
+      tempBuffer.swap(fSharedData.TempBuffer);
+      drawLists.swap(fSharedData.DrawLists);
+      fSharedData = iSharedData;
+      fSharedData.TempBuffer.swap(tempBuffer);
+      fSharedData.DrawLists.swap(drawLists);
+    }
+
+    ImDrawListSharedData fSharedData; // (declared first: fDrawList registers itself with it)
+    ImDrawList fDrawList;
+    ImDrawList *fHost{};
+    Job fJob{};
+  };
+
+  bool isSplicedFor(ImDrawList const *iList, ImDrawList const *iHost) const
+  {
+    for(int i = 0; i < fJobCount; i++)
+    {
+      if(&fEntries[i]->fDrawList == iList)
+        return fEntries[i]->fHost == iHost;
+    }
+    return false;
+  }
+
+  void runJobs(int iJobCount)
+  {
+    int completed = 0;
+    for(int job = fNextJob.fetch_add(1); job < iJobCount; job = fNextJob.fetch_add(1))
+    {
+      auto &entry = *fEntries[job];
+      entry.fJob(&entry.fDrawList);
+      completed++;
+    }
+
+    if(completed > 0)
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fPendingJobs -= completed;
+    }
+  }
+
+  void workerLoop()
+  {
+    int generation;
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      generation = fGeneration;
+    }
+
+    while(true)
+    {
+      int jobCount;
+      {
+        std::unique_lock<std::mutex> lock(fMutex);
+        fWorkAvailable.wait(lock, [this, generation] { return fStopping || fGeneration != generation; });
+        if(fStopping)
+          return;
+        generation = fGeneration;
+        jobCount = fBuildJobCount;
+        fActiveWorkers++;
+      }
+
+      runJobs(jobCount);
+
+      {
+        std::lock_guard<std::mutex> lock(fMutex);
+        fActiveWorkers--;
+      }
+      fWorkDone.notify_all();
+    }
+  }
+
+  void startWorkers(int iWorkerCount)
+  {
+    fStopping = false;
+    for(int i = 0; i < iWorkerCount; i++)
+      fWorkers.emplace_back([this] { workerLoop(); });
+  }
+
+  void stopWorkers()
+  {
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fStopping = true;
+    }
+    fWorkAvailable.notify_all();
+    for(auto &worker: fWorkers)
+      worker.join();
+    fWorkers.clear();
+  }
+
+private:
+  std::vector<std::thread> fWorkers{};
+  std::vector<std::unique_ptr<Entry>> fEntries{};
+  int fJobCount{};
+
+  std::mutex fMutex{};
+  std::condition_variable fWorkAvailable{};
+  std::condition_variable fWorkDone{};
+  std::atomic<int> fNextJob{};
+  int fPendingJobs{};
+  int fBuildJobCount{};
+  int fActiveWorkers{};
+  int fGeneration{};
+  bool fStopping{};
+};
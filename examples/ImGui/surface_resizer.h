@@ -0,0 +1,85 @@
+// Surface/canvas resize coordinator shared by the examples
+//
+// During an interactive resize (window drag), the size of the canvas changes on every frame. Reconfiguring the
+// surface every time reallocates its textures (and those of the attachments depending on its size) on every frame.
+// SurfaceResizer coalesces the size changes instead: the surface is only reconfigured once the requested size has
+// not changed for settleDelayMs, so at most once per settled size. In the meantime, the browser stretches the
+// canvas content.
+//
+// SurfaceResizer only controls the surface configuration (and what the application allocates with it): whoever owns
+// the canvas size still decides when its backing store is reallocated (the Dawn example owns its canvas and only
+// changes its css size during a resize, so nothing is reallocated until the size settles). The GLFW example does not
+// own the canvas size: emscripten-glfw (emscripten_glfw_make_canvas_resizable) sets the canvas width and height on every
+// resize event, so the browser still reallocates the canvas (and the textures returned by the surface) at that rate.
+//
+// The size in pixels is the size in css pixels times the pixel ratio (devicePixelRatio), capped to maxPixelRatio
+// (rendering at 3x on some phones costs 2.25 times the pixels of 2x for little visual difference) and to
+// maxDimension (set it to the device maxTextureDimension2D limit).
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+struct SurfaceResizer
+{
+  double settleDelayMs{150};
+  float maxPixelRatio{2.0f};
+  int maxDimension{8192};
+
+  // Call once per frame with the size of the canvas in css pixels and its pixel ratio. Returns true when the surface
+  // must be reconfigured to width x height (the first size is applied right away).
+  bool update(int iCssWidth, int iCssHeight, float iPixelRatio, double iNowMs)
+  {
+    // minimized (or not laid out yet): keeps the current size
+    if(iCssWidth <= 0 || iCssHeight <= 0)
+      return false;
+
+    auto ratio = std::min(iPixelRatio, maxPixelRatio);
+    auto w = std::clamp(static_cast<int>(std::lround(iCssWidth * ratio)), 1, maxDimension);
+    auto h = std::clamp(static_cast<int>(std::lround(iCssHeight * ratio)), 1, maxDimension);
+
+    if(w == width && h == height)
+    {
+      pending = false;
+      return false;
+    }
+
+    // a new size restarts the delay
+    if(!pending || w != pendingWidth || h != pendingHeight)
+    {
+      pending = true;
+      pendingWidth = w;
+      pendingHeight = h;
+      pendingSinceMs = iNowMs;
+      sizeChanges++;
+    }
+
+    if(configurations > 0 && iNowMs - pendingSinceMs < settleDelayMs)
+      return false;
+
+    pending = false;
+    width = w;
+    height = h;
+    scaleX = static_cast<float>(w) / iCssWidth;
+    scaleY = static_cast<float>(h) / iCssHeight;
+    configurations++;
+    return true;
+  }
+
+  // Size and scale (pixels per css pixel) of the surface as configured
+  int width{};
+  int height{};
+  float scaleX{1.0f};
+  float scaleY{1.0f};
+
+  // A size change is waiting for the delay to expire (the main loop must keep running)
+  bool pending{false};
+  int pendingWidth{};
+  int pendingHeight{};
+  double pendingSinceMs{};
+
+  // Statistics: number of distinct sizes requested vs number of surface configurations
+  int sizeChanges{};
+  int configurations{};
+};
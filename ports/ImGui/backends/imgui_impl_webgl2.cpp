@@ -0,0 +1,775 @@
+// Alternate WebGL2 renderer for ImGui (renderer=webgl2, see imgui_impl_webgl2.h)
+
+#include "imgui.h"
+#ifndef IMGUI_DISABLE
+
+#include "imgui_impl_opengl3.h"
+#include "imgui_impl_webgl2.h"
+#include "imgui_texture_uploads.h"
+
+#include <GLES3/gl3.h>
+#include <emscripten/html5.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+//------------------------------------------------------------------------
+// Constants
+//------------------------------------------------------------------------
+// ImDrawVert::uv is either 2 x float (default) or 2 x unorm16 (port option compactVertex=true)
+constexpr bool kFloatUV = sizeof(ImDrawVert::uv) == 2 * sizeof(float);
+
+constexpr char const *kVertexShader = R"(#version 300 es
+precision highp float;
+layout (location = 0) in vec2 Position;
+layout (location = 1) in vec2 UV;
+layout (location = 2) in vec4 Color;
+uniform mat4 ProjMtx;
+out vec2 Frag_UV;
+out vec4 Frag_Color;
+void main()
+{
+  Frag_UV = UV;
+  Frag_Color = Color;
+  gl_Position = ProjMtx * vec4(Position.xy, 0, 1);
+}
+)";
+
+constexpr char const *kFragmentShader = R"(#version 300 es
+precision mediump float;
+uniform sampler2D Texture;
+in vec2 Frag_UV;
+in vec4 Frag_Color;
+layout (location = 0) out vec4 Out_Color;
+void main()
+{
+  Out_Color = Frag_Color * texture(Texture, Frag_UV.st);
+}
+)";
+
+struct ScissorRect
+{
+  GLint fX, fY, fWidth, fHeight;
+  bool operator==(ScissorRect const &iOther) const
+  {
+    return fX == iOther.fX && fY == iOther.fY && fWidth == iOther.fWidth && fHeight == iOther.fHeight;
+  }
+  bool operator!=(ScissorRect const &iOther) const { return !(*this == iOther); }
+};
+
+inline GLuint toGLTexture(ImTextureID iTexture) { return static_cast<GLuint>(static_cast<intptr_t>(iTexture)); }
+
+//------------------------------------------------------------------------
+// WebGL2Renderer
+//------------------------------------------------------------------------
+class WebGL2Renderer
+{
+public:
+  ~WebGL2Renderer() { destroyDeviceObjects(); }
+
+  bool hasDeviceObjects() const { return fProgram != 0; }
+  bool createDeviceObjects();
+  void destroyDeviceObjects();
+  void updateTexture(ImTextureData *iTexture);
+  void renderDrawData(ImDrawData *iDrawData);
+  void setOwnsContext(bool iOwnsContext) { fOwnsContext = iOwnsContext; fStateValid = false; }
+  void setTextureUploadBudget(size_t iMaxBytesPerFrame) { fTextureUploads.setMaxBytesPerFrame(iMaxBytesPerFrame); }
+  ImGui_ImplWebGL2_Stats const &getStats() const { return fStats; }
+
+private:
+  // the state modified by this renderer, saved/restored when the application owns the context
+  struct GLStateBackup
+  {
+    GLint fActiveTexture, fProgram, fTexture, fSampler, fArrayBuffer, fVertexArray;
+    GLint fViewport[4], fScissorBox[4];
+    GLint fBlendSrcRGB, fBlendDstRGB, fBlendSrcAlpha, fBlendDstAlpha, fBlendEquationRGB, fBlendEquationAlpha;
+    GLboolean fBlend, fCullFace, fDepthTest, fStencilTest, fScissorTest;
+  };
+
+  // draw command once its indices have been rebased (fCallback is set for user callbacks)
+  struct Command
+  {
+    ImDrawList const *fList;
+    ImDrawCmd const *fCmd;
+    ImTextureID fTexture;
+    ScissorRect fScissor;
+    uint32_t fFirstIndex;
+    uint32_t fIndexCount;
+  };
+
+  // every GL call is a call into javascript: they are all counted
+  template<typename F, typename... Args>
+  auto call(F iFunction, Args... iArgs) -> decltype(iFunction(iArgs...))
+  {
+    fStats.GLCalls++;
+    return iFunction(iArgs...);
+  }
+
+  void saveState(GLStateBackup &oBackup);
+  void restoreState(GLStateBackup const &iBackup);
+  void setupRenderState(int iFramebufferWidth, int iFramebufferHeight, ImDrawData const *iDrawData);
+  template<typename T>
+  void prepareCommands(ImDrawData const *iDrawData, int iFramebufferWidth, int iFramebufferHeight);
+  void upload(GLenum iTarget, std::vector<uint8_t> const &iData, GLsizeiptr &ioCapacity);
+  void draw(Command const &iBatch);
+  void destroyTexture(ImTextureData *iTexture);
+  void flushTextureUploads();
+
+private:
+  GLuint fProgram{};
+  GLint fProjectionLocation{};
+  GLuint fVertexArray{};
+  GLuint fVertexBuffer{};
+  GLuint fIndexBuffer{};
+  GLsizeiptr fVertexBufferCapacity{};
+  GLsizeiptr fIndexBufferCapacity{};
+
+  // vertices and (rebased) indices of all the draw lists of the frame
+  std::vector<uint8_t> fVertices{};
+  std::vector<uint8_t> fIndices{};
+  GLenum fIndexType{GL_UNSIGNED_SHORT};
+  size_t fIndexSize{sizeof(uint16_t)};
+  std::vector<Command> fCommands{};
+
+  // when ImGui owns the context, the state set by setupRenderState stays valid from one frame to the next
+  bool fOwnsContext{};
+  bool fStateValid{};
+  float fProjection[4]{};
+  bool fHasProjection{};
+  bool fHasBoundTexture{};
+  ImTextureID fBoundTexture{};
+  bool fHasBoundScissor{};
+  ScissorRect fBoundScissor{};
+
+  // texture updates (glyphs rasterized by ImGui) merged and uploaded within a budget of bytes per frame
+  ImGui_ImplTextureUploads fTextureUploads{};
+
+  ImGui_ImplWebGL2_Stats fStats{};
+};
+
+//------------------------------------------------------------------------
+// CompileShader
+//------------------------------------------------------------------------
+GLuint CompileShader(GLenum iType, char const *iSource)
+{
+  auto shader = glCreateShader(iType);
+  glShaderSource(shader, 1, &iSource, nullptr);
+  glCompileShader(shader);
+  GLint status = 0;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+  if(status == GL_FALSE)
+  {
+    char log[1024];
+    glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+    fprintf(stderr, "ERROR: imgui_impl_webgl2: failed to compile %s shader: %s\n",
+            iType == GL_VERTEX_SHADER ? "vertex" : "fragment", log);
+  }
+  return shader;
+}
+
+//------------------------------------------------------------------------
+// WebGL2Renderer::createDeviceObjects
+//------------------------------------------------------------------------
+bool WebGL2Renderer::createDeviceObjects()
+{
+  if(hasDeviceObjects())
+    destroyDeviceObjects();
+
+  GLStateBackup backup{};
+  if(!fOwnsContext)
+    saveState(backup);
+
+  auto vertexShader = CompileShader(GL_VERTEX_SHADER, kVertexShader);
+  auto fragmentShader = CompileShader(GL_FRAGMENT_SHADER, kFragmentShader);
+  fProgram = glCreateProgram();
+  glAttachShader(fProgram, vertexShader);
+  glAttachShader(fProgram, fragmentShader);
+  glLinkProgram(fProgram);
+  glDetachShader(fProgram, vertexShader);
+  glDetachShader(fProgram, fragmentShader);
+  glDeleteShader(vertexShader);
+  glDeleteShader(fragmentShader);
+
+  GLint status = 0;
+  glGetProgramiv(fProgram, GL_LINK_STATUS, &status);
+  if(status == GL_FALSE)
+  {
+    char log[1024];
+    glGetProgramInfoLog(fProgram, sizeof(log), nullptr, log);
+    fprintf(stderr, "ERROR: imgui_impl_webgl2: failed to link program: %s\n", log);
+    glDeleteProgram(fProgram);
+    fProgram = 0;
+    if(!fOwnsContext)
+      restoreState(backup);
+    return false;
+  }
+
+  // the sampler always uses texture unit 0
+  fProjectionLocation = glGetUniformLocation(fProgram, "ProjMtx");
+  glUseProgram(fProgram);
+  glUniform1i(glGetUniformLocation(fProgram, "Texture"), 0);
+
+  // the vertex array object captures the attributes (and the index buffer) once and for all
+  glGenVertexArrays(1, &fVertexArray);
+  glGenBuffers(1, &fVertexBuffer);
+  glGenBuffers(1, &fIndexBuffer);
+  glBindVertexArray(fVertexArray);
+  glBindBuffer(GL_ARRAY_BUFFER, fVertexBuffer);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, fIndexBuffer);
+  glEnableVertexAttribArray(0);
+  glEnableVertexAttribArray(1);
+  glEnableVertexAttribArray(2);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert),
+                        reinterpret_cast<GLvoid *>(offsetof(ImDrawVert, pos)));
+  glVertexAttribPointer(1, 2, kFloatUV ? GL_FLOAT : GL_UNSIGNED_SHORT, kFloatUV ? GL_FALSE : GL_TRUE,
+                        sizeof(ImDrawVert), reinterpret_cast<GLvoid *>(offsetof(ImDrawVert, uv)));
+  glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert),
+                        reinterpret_cast<GLvoid *>(offsetof(ImDrawVert, col)));
+  glBindVertexArray(0);
+  fVertexBufferCapacity = 0;
+  fIndexBufferCapacity = 0;
+
+  if(fOwnsContext)
+    fStateValid = false;
+  else
+    restoreState(backup);
+
+  return true;
+}
+
+//------------------------------------------------------------------------
+// WebGL2Renderer::destroyDeviceObjects
+//------------------------------------------------------------------------
+void WebGL2Renderer::destroyDeviceObjects()
+{
+  // destroys the textures which are only referenced by ImGui (and not by another ImGui context)
+  for(auto texture: ImGui::GetPlatformIO().Textures)
+  {
+    if(texture->RefCount == 1)
+      destroyTexture(texture);
+  }
+
+  if(fVertexArray)
+    glDeleteVertexArrays(1, &fVertexArray);
+  if(fVertexBuffer)
+    glDeleteBuffers(1, &fVertexBuffer);
+  if(fIndexBuffer)
+    glDeleteBuffers(1, &fIndexBuffer);
+  if(fProgram)
+    glDeleteProgram(fProgram);
+  fVertexArray = 0;
+  fVertexBuffer = 0;
+  fIndexBuffer = 0;
+  fProgram = 0;
+  fStateValid = false;
+}
+
+//------------------------------------------------------------------------
+// WebGL2Renderer::saveState
+//------------------------------------------------------------------------
+void WebGL2Renderer::saveState(GLStateBackup &oBackup)
+{
+  call(glGetIntegerv, GL_ACTIVE_TEXTURE, &oBackup.fActiveTexture);
+  call(glActiveTexture, GL_TEXTURE0);
+  call(glGetIntegerv, GL_CURRENT_PROGRAM, &oBackup.fProgram);
+  call(glGetIntegerv, GL_TEXTURE_BINDING_2D, &oBackup.fTexture);
+  call(glGetIntegerv, GL_SAMPLER_BINDING, &oBackup.fSampler);
+  call(glGetIntegerv, GL_ARRAY_BUFFER_BINDING, &oBackup.fArrayBuffer);
+  call(glGetIntegerv, GL_VERTEX_ARRAY_BINDING, &oBackup.fVertexArray);
+  call(glGetIntegerv, GL_VIEWPORT, oBackup.fViewport);
+  call(glGetIntegerv, GL_SCISSOR_BOX, oBackup.fScissorBox);
+  call(glGetIntegerv, GL_BLEND_SRC_RGB, &oBackup.fBlendSrcRGB);
+  call(glGetIntegerv, GL_BLEND_DST_RGB, &oBackup.fBlendDstRGB);
+  call(glGetIntegerv, GL_BLEND_SRC_ALPHA, &oBackup.fBlendSrcAlpha);
+  call(glGetIntegerv, GL_BLEND_DST_ALPHA, &oBackup.fBlendDstAlpha);
+  call(glGetIntegerv, GL_BLEND_EQUATION_RGB, &oBackup.fBlendEquationRGB);
+  call(glGetIntegerv, GL_BLEND_EQUATION_ALPHA, &oBackup.fBlendEquationAlpha);
+  oBackup.fBlend = call(glIsEnabled, GL_BLEND);
+  oBackup.fCullFace = call(glIsEnabled, GL_CULL_FACE);
+  oBackup.fDepthTest = call(glIsEnabled, GL_DEPTH_TEST);
+  oBackup.fStencilTest = call(glIsEnabled, GL_STENCIL_TEST);
+  oBackup.fScissorTest = call(glIsEnabled, GL_SCISSOR_TEST);
+}
+
+//------------------------------------------------------------------------
+// WebGL2Renderer::restoreState
+//------------------------------------------------------------------------
+void WebGL2Renderer::restoreState(GLStateBackup const &iBackup)
+{
+  auto enable = [this](GLenum iCap, GLboolean iEnabled) {
+    if(iEnabled)
+      call(glEnable, iCap);
+    else
+      call(glDisable, iCap);
+  };
+
+  call(glUseProgram, static_cast<GLuint>(iBackup.fProgram));
+  call(glBindTexture, GL_TEXTURE_2D, static_cast<GLuint>(iBackup.fTexture));
+  call(glBindSampler, 0, static_cast<GLuint>(iBackup.fSampler));
+  call(glActiveTexture, static_cast<GLenum>(iBackup.fActiveTexture));
+  call(glBindVertexArray, static_cast<GLuint>(iBackup.fVertexArray));
+  call(glBindBuffer, GL_ARRAY_BUFFER, static_cast<GLuint>(iBackup.fArrayBuffer));
+  call(glBlendEquationSeparate, static_cast<GLenum>(iBackup.fBlendEquationRGB),
+       static_cast<GLenum>(iBackup.fBlendEquationAlpha));
+  call(glBlendFuncSeparate, static_cast<GLenum>(iBackup.fBlendSrcRGB), static_cast<GLenum>(iBackup.fBlendDstRGB),
+       static_cast<GLenum>(iBackup.fBlendSrcAlpha), static_cast<GLenum>(iBackup.fBlendDstAlpha));
+  enable(GL_BLEND, iBackup.fBlend);
+  enable(GL_CULL_FACE, iBackup.fCullFace);
+  enable(GL_DEPTH_TEST, iBackup.fDepthTest);
+  enable(GL_STENCIL_TEST, iBackup.fStencilTest);
+  enable(GL_SCISSOR_TEST, iBackup.fScissorTest);
+  call(glViewport, iBackup.fViewport[0], iBackup.fViewport[1], iBackup.fViewport[2], iBackup.fViewport[3]);
+  call(glScissor, iBackup.fScissorBox[0], iBackup.fScissorBox[1], iBackup.fScissorBox[2], iBackup.fScissorBox[3]);
+
+  // none of the state set by this renderer is left
+  fStateValid = false;
+}
+
+//------------------------------------------------------------------------
+// WebGL2Renderer::setupRenderState
+//------------------------------------------------------------------------
+void WebGL2Renderer::setupRenderState(int iFramebufferWidth, int iFramebufferHeight, ImDrawData const *iDrawData)
+{
+  // alpha blending enabled, no face culling, no depth testing, scissor enabled
+  if(!fStateValid)
+  {
+    call(glEnable, GL_BLEND);
+    call(glBlendEquation, GL_FUNC_ADD);
+    call(glBlendFuncSeparate, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    call(glDisable, GL_CULL_FACE);
+    call(glDisable, GL_DEPTH_TEST);
+    call(glDisable, GL_STENCIL_TEST);
+    call(glUseProgram, fProgram);
+    call(glBindSampler, 0, 0u);
+    call(glBindVertexArray, fVertexArray);
+    call(glBindBuffer, GL_ARRAY_BUFFER, fVertexBuffer);
+    // (part of the vertex array state, which the application may have changed while it was bound)
+    call(glBindBuffer, GL_ELEMENT_ARRAY_BUFFER, fIndexBuffer);
+    fStateValid = true;
+    fHasProjection = false;
+    fHasBoundTexture = false;
+    fHasBoundScissor = false;
+  }
+  call(glEnable, GL_SCISSOR_TEST);
+
+  // the application may have changed it (ex: glViewport before glClear)
+  call(glViewport, 0, 0, static_cast<GLsizei>(iFramebufferWidth), static_cast<GLsizei>(iFramebufferHeight));
+
+  // our visible imgui space lies from DisplayPos (top left) to DisplayPos+DisplaySize (bottom right)
+  float L = iDrawData->DisplayPos.x;
+  float R = iDrawData->DisplayPos.x + iDrawData->DisplaySize.x;
+  float T = iDrawData->DisplayPos.y;
+  float B = iDrawData->DisplayPos.y + iDrawData->DisplaySize.y;
+  if(!fHasProjection || fProjection[0] != L || fProjection[1] != R || fProjection[2] != T || fProjection[3] != B)
+  {
+    float const projection[4][4] = {
+      {2.0f / (R - L), 0.0f, 0.0f, 0.0f},
+      {0.0f, 2.0f / (T - B), 0.0f, 0.0f},
+      {0.0f, 0.0f, -1.0f, 0.0f},
+      {(R + L) / (L - R), (T + B) / (B - T), 0.0f, 1.0f},
+    };
+    call(glUniformMatrix4fv, fProjectionLocation, 1, static_cast<GLboolean>(GL_FALSE), &projection[0][0]);
+    fProjection[0] = L;
+    fProjection[1] = R;
+    fProjection[2] = T;
+    fProjection[3] = B;
+    fHasProjection = true;
+  }
+}
+
+//------------------------------------------------------------------------
+// WebGL2Renderer::prepareCommands
+// Copies the vertices and indices of all the draw lists in a single buffer each. The indices are rebased (WebGL2 has
+// no base vertex) and the bounding box of the vertices of each command is computed on the way: when it lies inside
+// the clip rectangle, the command does not need a scissor, so it can be merged with its neighbours.
+//------------------------------------------------------------------------
+template<typename T>
+void WebGL2Renderer::prepareCommands(ImDrawData const *iDrawData, int iFramebufferWidth, int iFramebufferHeight)
+{
+  fCommands.clear();
+  fVertices.resize(static_cast<size_t>(iDrawData->TotalVtxCount) * sizeof(ImDrawVert));
+  fIndices.resize(static_cast<size_t>(iDrawData->TotalIdxCount) * sizeof(T));
+
+  auto const fullScissor = ScissorRect{0, 0, iFramebufferWidth, iFramebufferHeight};
+  auto clipOffset = iDrawData->DisplayPos;         // (0,0) unless using multi-viewports
+  auto clipScale = iDrawData->FramebufferScale;    // (1,1) unless using retina display which are often (2,2)
+  auto vertices = fVertices.data();
+  auto indices = reinterpret_cast<T *>(fIndices.data());
+  uint32_t globalVertexOffset = 0;
+  uint32_t globalIndexOffset = 0;
+  for(auto list: iDrawData->CmdLists)
+  {
+    auto vertexBytes = static_cast<size_t>(list->VtxBuffer.Size) * sizeof(ImDrawVert);
+    std::memcpy(vertices, list->VtxBuffer.Data, vertexBytes);
+    vertices += vertexBytes;
+
+    for(auto const &cmd: list->CmdBuffer)
+    {
+      if(cmd.UserCallback != nullptr)
+      {
+        fCommands.push_back(Command{list, &cmd, ImTextureID_Invalid, {}, 0, 0});
+        continue;
+      }
+
+      // projects the clip rectangle into framebuffer space
+      ImVec2 clipMin((cmd.ClipRect.x - clipOffset.x) * clipScale.x, (cmd.ClipRect.y - clipOffset.y) * clipScale.y);
+      ImVec2 clipMax((cmd.ClipRect.z - clipOffset.x) * clipScale.x, (cmd.ClipRect.w - clipOffset.y) * clipScale.y);
+      if(clipMax.x <= clipMin.x || clipMax.y <= clipMin.y)
+        continue;
+
+      auto src = list->IdxBuffer.Data + cmd.IdxOffset;
+      auto srcVertices = list->VtxBuffer.Data + cmd.VtxOffset;
+      auto dst = indices + globalIndexOffset + cmd.IdxOffset;
+      auto base = globalVertexOffset + cmd.VtxOffset;
+      ImVec2 min(FLT_MAX, FLT_MAX);
+      ImVec2 max(-FLT_MAX, -FLT_MAX);
+      for(unsigned int i = 0; i < cmd.ElemCount; i++)
+      {
+        auto index = src[i];
+        dst[i] = static_cast<T>(index + base);
+        auto const &pos = srcVertices[index].pos;
+        min.x = std::min(min.x, pos.x);
+        min.y = std::min(min.y, pos.y);
+        max.x = std::max(max.x, pos.x);
+        max.y = std::max(max.y, pos.y);
+      }
+
+      ScissorRect scissor = fullScissor;
+      if(min.x < cmd.ClipRect.x || min.y < cmd.ClipRect.y || max.x > cmd.ClipRect.z || max.y > cmd.ClipRect.w)
+      {
+        // the scissor rectangle is clamped and its origin is bottom left
+        clipMin.x = std::max(clipMin.x, 0.0f);
+        clipMin.y = std::max(clipMin.y, 0.0f);
+        clipMax.x = std::min(clipMax.x, static_cast<float>(iFramebufferWidth));
+        clipMax.y = std::min(clipMax.y, static_cast<float>(iFramebufferHeight));
+        if(clipMax.x <= clipMin.x || clipMax.y <= clipMin.y)
+          continue;
+        scissor = ScissorRect{static_cast<GLint>(clipMin.x), static_cast<GLint>(iFramebufferHeight - clipMax.y),
+                              static_cast<GLint>(clipMax.x - clipMin.x), static_cast<GLint>(clipMax.y - clipMin.y)};
+      }
+
+      fCommands.push_back(Command{list, &cmd, cmd.GetTexID(), scissor, globalIndexOffset + cmd.IdxOffset,
+                                  cmd.ElemCount});
+    }
+
+    globalVertexOffset += static_cast<uint32_t>(list->VtxBuffer.Size);
+    globalIndexOffset += static_cast<uint32_t>(list->IdxBuffer.Size);
+  }
+
+  fIndexType = sizeof(T) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+  fIndexSize = sizeof(T);
+}
+
+//------------------------------------------------------------------------
+// WebGL2Renderer::upload
+//------------------------------------------------------------------------
+void WebGL2Renderer::upload(GLenum iTarget, std::vector<uint8_t> const &iData, GLsizeiptr &ioCapacity)
+{
+  auto size = static_cast<GLsizeiptr>(iData.size());
+
+  // the storage is only reallocated when the frame does not fit (WebGL copies the data on glBufferSubData, so the
+  // upload never waits for the previous frame: reallocating the whole capacity every frame would only cost more)
+  if(ioCapacity < size)
+  {
+    while(ioCapacity < size)
+      ioCapacity = std::max<GLsizeiptr>(ioCapacity * 2, 64 * 1024);
+    call(glBufferData, iTarget, ioCapacity, nullptr, static_cast<GLenum>(GL_STREAM_DRAW));
+  }
+  call(glBufferSubData, iTarget, static_cast<GLintptr>(0), size, static_cast<void const *>(iData.data()));
+  fStats.UploadBytes += iData.size();
+}
+
+//------------------------------------------------------------------------
+// WebGL2Renderer::draw
+//------------------------------------------------------------------------
+void WebGL2Renderer::draw(Command const &iBatch)
+{
+  if(!fHasBoundTexture || fBoundTexture != iBatch.fTexture)
+  {
+    call(glBindTexture, GL_TEXTURE_2D, toGLTexture(iBatch.fTexture));
+    fBoundTexture = iBatch.fTexture;
+    fHasBoundTexture = true;
+  }
+
+  if(!fHasBoundScissor || fBoundScissor != iBatch.fScissor)
+  {
+    call(glScissor, iBatch.fScissor.fX, iBatch.fScissor.fY, iBatch.fScissor.fWidth, iBatch.fScissor.fHeight);
+    fBoundScissor = iBatch.fScissor;
+    fHasBoundScissor = true;
+  }
+
+  call(glDrawElements, GL_TRIANGLES, static_cast<GLsizei>(iBatch.fIndexCount), fIndexType,
+       reinterpret_cast<void const *>(static_cast<intptr_t>(iBatch.fFirstIndex * fIndexSize)));
+  fStats.DrawCalls++;
+}
+
+//------------------------------------------------------------------------
+// WebGL2Renderer::updateTexture
+//------------------------------------------------------------------------
+void WebGL2Renderer::updateTexture(ImTextureData *iTexture)
+{
+  // the texture binding changes below
+  fHasBoundTexture = false;
+
+  if(iTexture->Status == ImTextureStatus_WantCreate)
+  {
+    IM_ASSERT(iTexture->TexID == ImTextureID_Invalid && iTexture->BackendUserData == nullptr);
+    fTextureUploads.forget(iTexture);
+    IM_ASSERT(iTexture->Format == ImTextureFormat_RGBA32);
+    GLuint texture = 0;
+    call(glGenTextures, 1, &texture);
+    call(glBindTexture, GL_TEXTURE_2D, texture);
+    call(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    call(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    call(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    call(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    call(glPixelStorei, GL_UNPACK_ROW_LENGTH, 0);
+    call(glTexImage2D, GL_TEXTURE_2D, 0, GL_RGBA, iTexture->Width, iTexture->Height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+         static_cast<void const *>(iTexture->GetPixels()));
+    iTexture->SetTexID(static_cast<ImTextureID>(static_cast<intptr_t>(texture)));
+    iTexture->SetStatus(ImTextureStatus_OK);
+  }
+  else if(iTexture->Status == ImTextureStatus_WantUpdates)
+  {
+    // uploaded by flushTextureUploads (merged with the pending updates, within the budget)
+    fTextureUploads.enqueue(iTexture);
+  }
+  else if(iTexture->Status == ImTextureStatus_WantDestroy && iTexture->UnusedFrames > 0)
+    destroyTexture(iTexture);
+}
+
+//------------------------------------------------------------------------
+// WebGL2Renderer::destroyTexture
+//------------------------------------------------------------------------
+void WebGL2Renderer::destroyTexture(ImTextureData *iTexture)
+{
+  fTextureUploads.forget(iTexture);
+  auto texture = toGLTexture(iTexture->TexID);
+  call(glDeleteTextures, 1, static_cast<GLuint const *>(&texture));
+  if(fHasBoundTexture && fBoundTexture == iTexture->TexID)
+    fHasBoundTexture = false;
+  iTexture->SetTexID(ImTextureID_Invalid);
+  iTexture->SetStatus(ImTextureStatus_Destroyed);
+}
+
+//------------------------------------------------------------------------
+// WebGL2Renderer::flushTextureUploads
+//------------------------------------------------------------------------
+void WebGL2Renderer::flushTextureUploads()
+{
+  // UNPACK_ROW_LENGTH lets WebGL read the rectangle straight from the texture pixels (no staging copy)
+  GLint rowLength = 0;
+  auto upload = [this, &rowLength](ImGui_ImplTextureUploads::Upload const &iUpload) {
+    auto texture = iUpload.fTexture;
+    if(rowLength != texture->Width)
+    {
+      rowLength = texture->Width;
+      call(glPixelStorei, GL_UNPACK_ROW_LENGTH, rowLength);
+    }
+    if(!fHasBoundTexture || fBoundTexture != texture->TexID)
+    {
+      call(glBindTexture, GL_TEXTURE_2D, toGLTexture(texture->TexID));
+      fHasBoundTexture = true;
+      fBoundTexture = texture->TexID;
+    }
+    call(glTexSubImage2D, GL_TEXTURE_2D, 0, static_cast<GLint>(iUpload.fX), static_cast<GLint>(iUpload.fY),
+         static_cast<GLsizei>(iUpload.fWidth), static_cast<GLsizei>(iUpload.fHeight), static_cast<GLenum>(GL_RGBA),
+         static_cast<GLenum>(GL_UNSIGNED_BYTE), static_cast<void const *>(texture->GetPixelsAt(iUpload.fX, iUpload.fY)));
+    fStats.TextureUploads++;
+  };
+  fStats.TextureUploadBytes = fTextureUploads.flush(upload);
+  if(rowLength != 0)
+    call(glPixelStorei, GL_UNPACK_ROW_LENGTH, 0);
+  fStats.TexturePendingBytes = fTextureUploads.getPendingBytes();
+}
+
+//------------------------------------------------------------------------
+// WebGL2Renderer::renderDrawData
+//------------------------------------------------------------------------
+void WebGL2Renderer::renderDrawData(ImDrawData *iDrawData)
+{
+  fStats = ImGui_ImplWebGL2_Stats{};
+
+  // avoid rendering when minimized
+  int framebufferWidth = static_cast<int>(iDrawData->DisplaySize.x * iDrawData->FramebufferScale.x);
+  int framebufferHeight = static_cast<int>(iDrawData->DisplaySize.y * iDrawData->FramebufferScale.y);
+  if(framebufferWidth <= 0 || framebufferHeight <= 0)
+    return;
+
+  GLStateBackup backup{};
+  if(!fOwnsContext)
+    saveState(backup);
+
+  setupRenderState(framebufferWidth, framebufferHeight, iDrawData);
+
+  // catch up with texture updates (most of the time, the list will have 1 element with an OK status)
+  if(iDrawData->Textures)
+  {
+    for(auto texture: *iDrawData->Textures)
+    {
+      if(texture->Status != ImTextureStatus_OK)
+        updateTexture(texture);
+    }
+  }
+  flushTextureUploads();
+
+  if(iDrawData->TotalVtxCount > 0 && iDrawData->TotalIdxCount > 0)
+  {
+    // 16-bit indices as long as all the vertices of the frame can be addressed with them
+    if(iDrawData->TotalVtxCount <= 0x10000)
+      prepareCommands<uint16_t>(iDrawData, framebufferWidth, framebufferHeight);
+    else
+      prepareCommands<uint32_t>(iDrawData, framebufferWidth, framebufferHeight);
+
+    upload(GL_ARRAY_BUFFER, fVertices, fVertexBufferCapacity);
+    upload(GL_ELEMENT_ARRAY_BUFFER, fIndices, fIndexBufferCapacity);
+
+    Command batch{};
+    bool hasBatch = false;
+    for(auto const &command: fCommands)
+    {
+      fStats.DrawCommands++;
+
+      if(command.fCmd->UserCallback != nullptr)
+      {
+        if(hasBatch)
+          draw(batch);
+        hasBatch = false;
+        if(command.fCmd->UserCallback == ImDrawCallback_ResetRenderState)
+        {
+          fStateValid = false;
+          setupRenderState(framebufferWidth, framebufferHeight, iDrawData);
+        }
+        else
+        {
+          command.fCmd->UserCallback(command.fList, command.fCmd);
+          // the callback may have changed any state (program, vertex array, buffers...): sets it up again
+          fStateValid = false;
+          setupRenderState(framebufferWidth, framebufferHeight, iDrawData);
+        }
+        continue;
+      }
+
+      // merges with the previous command when it draws the indices right before with the same state
+      if(hasBatch && batch.fTexture == command.fTexture && batch.fScissor == command.fScissor &&
+         batch.fFirstIndex + batch.fIndexCount == command.fFirstIndex)
+      {
+        batch.fIndexCount += command.fIndexCount;
+      }
+      else
+      {
+        if(hasBatch)
+          draw(batch);
+        batch = command;
+        hasBatch = true;
+      }
+    }
+    if(hasBatch)
+      draw(batch);
+  }
+
+  if(fOwnsContext)
+    call(glDisable, GL_SCISSOR_TEST); // so that the application glClear is not clipped
+  else
+    restoreState(backup);
+}
+
+WebGL2Renderer *GetWebGL2Renderer()
+{
+  return ImGui::GetCurrentContext() ? static_cast<WebGL2Renderer *>(ImGui::GetIO().BackendRendererUserData) : nullptr;
+}
+
+}
+
+//------------------------------------------------------------------------
+// ImGui_ImplOpenGL3 API (same as the stock backend)
+//------------------------------------------------------------------------
+bool ImGui_ImplOpenGL3_Init(const char *glsl_version)
+{
+  ImGuiIO &io = ImGui::GetIO();
+  IMGUI_CHECKVERSION();
+  IM_ASSERT(io.BackendRendererUserData == nullptr && "Already initialized a renderer backend!");
+
+  // the shaders are always "#version 300 es" which requires a WebGL2 context
+  IM_UNUSED(glsl_version);
+  EmscriptenWebGLContextAttributes attributes{};
+  IM_ASSERT(emscripten_webgl_get_current_context() != 0 &&
+            emscripten_webgl_get_context_attributes(emscripten_webgl_get_current_context(), &attributes) == EMSCRIPTEN_RESULT_SUCCESS &&
+            attributes.majorVersion >= 2 && "renderer=webgl2 requires a WebGL2 context");
+  IM_UNUSED(attributes);
+
+  io.BackendRendererUserData = new WebGL2Renderer();
+  io.BackendRendererName = "imgui_impl_webgl2";
+  io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset; // We can honor the ImDrawCmd::VtxOffset field, allowing for large meshes.
+  io.BackendFlags |= ImGuiBackendFlags_RendererHasTextures;  // We can honor ImGuiPlatformIO::Textures[] requests during render.
+  return true;
+}
+
+void ImGui_ImplOpenGL3_Shutdown()
+{
+  auto renderer = GetWebGL2Renderer();
+  IM_ASSERT(renderer != nullptr && "No renderer backend to shutdown, or already shutdown?");
+  ImGuiIO &io = ImGui::GetIO();
+
+  delete renderer;
+  io.BackendRendererName = nullptr;
+  io.BackendRendererUserData = nullptr;
+  io.BackendFlags &= ~(ImGuiBackendFlags_RendererHasVtxOffset | ImGuiBackendFlags_RendererHasTextures);
+}
+
+void ImGui_ImplOpenGL3_NewFrame()
+{
+  auto renderer = GetWebGL2Renderer();
+  IM_ASSERT(renderer != nullptr && "Context or backend not initialized! Did you call ImGui_ImplOpenGL3_Init()?");
+  if(!renderer->hasDeviceObjects())
+  {
+    auto created = renderer->createDeviceObjects();
+    IM_ASSERT(created && "ImGui_ImplOpenGL3_CreateDeviceObjects() failed!");
+    IM_UNUSED(created);
+  }
+}
+
+void ImGui_ImplOpenGL3_RenderDrawData(ImDrawData *draw_data)
+{
+  GetWebGL2Renderer()->renderDrawData(draw_data);
+}
+
+bool ImGui_ImplOpenGL3_CreateDeviceObjects()
+{
+  return GetWebGL2Renderer()->createDeviceObjects();
+}
+
+void ImGui_ImplOpenGL3_DestroyDeviceObjects()
+{
+  GetWebGL2Renderer()->destroyDeviceObjects();
+}
+
+void ImGui_ImplOpenGL3_UpdateTexture(ImTextureData *tex)
+{
+  GetWebGL2Renderer()->updateTexture(tex);
+}
+
+//------------------------------------------------------------------------
+// WebGL2 specific API
+//------------------------------------------------------------------------
+void ImGui_ImplWebGL2_SetOwnsContext(bool owns_context)
+{
+  GetWebGL2Renderer()->setOwnsContext(owns_context);
+}
+
+void ImGui_ImplWebGL2_SetTextureUploadBudget(size_t max_bytes_per_frame)
+{
+  GetWebGL2Renderer()->setTextureUploadBudget(max_bytes_per_frame);
+}
+
+ImGui_ImplWebGL2_Stats ImGui_ImplWebGL2_GetStats()
+{
+  auto renderer = GetWebGL2Renderer();
+  return renderer ? renderer->getStats() : ImGui_ImplWebGL2_Stats{};
+}
+
+#endif // #ifndef IMGUI_DISABLE
@@ -0,0 +1,49 @@
+// Alternate WebGL2 renderer for ImGui (renderer=webgl2)
+//
+// Drop-in replacement of the stock backends/imgui_impl_opengl3.cpp for a WebGL2 context: it implements the same API
+// (ImGui_ImplOpenGL3_Init, ImGui_ImplOpenGL3_RenderDrawData, ...) declared in backends/imgui_impl_opengl3.h, so the
+// application code does not change. Each GL call is a call into javascript, so a frame is submitted with as few
+// calls as possible:
+// - a vertex array object created once (the vertex attributes are never re-specified)
+// - the vertices and indices of all the draw lists are uploaded with 1 glBufferSubData per buffer (glBufferData only
+//   when the buffer grows; the indices are rebased, so draw lists do not need separate uploads or base vertex support)
+// - the texture and scissor rectangle are only set when they change, and consecutive draw commands sharing them are
+//   merged into a single draw call (the scissor is ignored for commands whose vertices lie inside their clip rect)
+// - the GL state is only saved/restored when the application does not own the context (see below)
+// - the texture updates (glyphs rasterized by ImGui) are merged and uploaded within a budget of bytes per frame (see
+//   imgui_texture_uploads.h), so that a burst of new glyphs is spread over several frames
+//
+// This header only adds the WebGL2 specific API.
+
+#pragma once
+
+#include "imgui.h"
+#ifndef IMGUI_DISABLE
+
+#include <stddef.h>
+
+// Declares that ImGui is the only user of the GL state (the application only clears the framebuffer, like in the
+// examples): the renderer then no longer saves/restores the GL state around ImGui_ImplOpenGL3_RenderDrawData and
+// only sets the state which changed since the previous frame. The scissor test is disabled at the end of each frame
+// so that glClear is not clipped. Must be called after ImGui_ImplOpenGL3_Init.
+IMGUI_IMPL_API void ImGui_ImplWebGL2_SetOwnsContext(bool owns_context);
+
+// Maximum number of bytes of texture updates uploaded per frame (256 KB by default, 0 for no limit). The updates
+// which do not fit are uploaded during the next frames. Must be called after ImGui_ImplOpenGL3_Init.
+IMGUI_IMPL_API void ImGui_ImplWebGL2_SetTextureUploadBudget(size_t max_bytes_per_frame);
+
+struct ImGui_ImplWebGL2_Stats
+{
+  // last frame (ImGui_ImplOpenGL3_RenderDrawData)
+  int DrawCommands;           // number of ImDrawCmd (the stock renderer issues one draw call per command)
+  int DrawCalls;              // number of draw calls issued after merging
+  int GLCalls;                // number of gl* calls (including the texture updates)
+  size_t UploadBytes;         // number of bytes uploaded (vertices + indices)
+  int TextureUploads;         // number of glTexSubImage2D (texture updates, after merging)
+  size_t TextureUploadBytes;  // number of bytes of texture updates uploaded
+  size_t TexturePendingBytes; // number of bytes of texture updates deferred to the next frames
+};
+
+IMGUI_IMPL_API ImGui_ImplWebGL2_Stats ImGui_ImplWebGL2_GetStats();
+
+#endif // #ifndef IMGUI_DISABLE
@@ -0,0 +1,955 @@
+// Alternate WebGPU renderer for ImGui (renderer=wgpu-ring, see imgui_impl_wgpu_ring.h)
+
+// The stock backend (backends/imgui_impl_wgpu.cpp) is not compiled: this file implements the whole API declared in
+// backends/imgui_impl_wgpu.h, including the helpers used by the applications (see the end of the file), so that a
+// new function declared by a future version of ImGui fails at link time instead of running with the wrong renderer
+// data.
+#include "imgui_impl_wgpu.h"
+#include "imgui_impl_wgpu_ring.h"
+#include "imgui_texture_uploads.h"
+
+#ifndef IMGUI_DISABLE
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+//------------------------------------------------------------------------
+// Constants
+//------------------------------------------------------------------------
+// the uniforms are at the start of each slot, followed by the vertices (256 bytes leaves room for the uniforms and
+// keeps the vertices aligned)
+constexpr uint64_t kVerticesOffset = 256;
+constexpr uint64_t kInitialSlotSize = 64 * 1024;
+
+// the slots start at a multiple of minUniformBufferOffsetAlignment (256 is the default limit and the maximum allowed)
+// since the uniforms are bound with a dynamic offset
+constexpr uint64_t kSlotAlignment = 256;
+
+// the bind groups of the textures which have not been used for this many frames are released
+// (ex: a user texture which is no longer displayed)
+constexpr uint64_t kBindGroupMaxAge = 120;
+
+// ImDrawVert::uv is either 2 x float (default) or 2 x unorm16 (port option compactVertex=true)
+constexpr WGPUVertexFormat kUVFormat = sizeof(ImDrawVert::uv) == 2 * sizeof(float) ?
+                                       WGPUVertexFormat_Float32x2 : WGPUVertexFormat_Unorm16x2;
+
+constexpr char const *kShaderWGSL = R"(
+struct Uniforms {
+  mvp: mat4x4<f32>,
+  gamma: f32,
+};
+
+struct VertexOutput {
+  @builtin(position) position: vec4<f32>,
+  @location(0) color: vec4<f32>,
+  @location(1) uv: vec2<f32>,
+};
+
+@group(0) @binding(0) var<uniform> uniforms: Uniforms;
+@group(0) @binding(1) var s: sampler;
+@group(1) @binding(0) var t: texture_2d<f32>;
+
+@vertex
+fn vs_main(@location(0) position: vec2<f32>, @location(1) uv: vec2<f32>, @location(2) color: vec4<f32>) -> VertexOutput {
+  var output: VertexOutput;
+  output.position = uniforms.mvp * vec4<f32>(position, 0.0, 1.0);
+  output.color = color;
+  output.uv = uv;
+  return output;
+}
+
+@fragment
+fn fs_main(input: VertexOutput) -> @location(0) vec4<f32> {
+  let color = input.color * textureSample(t, s, input.uv);
+  return vec4<f32>(pow(color.rgb, vec3<f32>(uniforms.gamma)), color.a);
+}
+)";
+
+// matches the Uniforms struct of the shader (80 bytes)
+struct RingUniforms
+{
+  float fMVP[4][4];
+  float fGamma;
+  float fPadding[3];
+};
+
+constexpr uint64_t alignUp(uint64_t iValue, uint64_t iAlignment)
+{
+  return (iValue + iAlignment - 1) / iAlignment * iAlignment;
+}
+
+struct ScissorRect
+{
+  uint32_t fX, fY, fWidth, fHeight;
+  bool operator==(ScissorRect const &iOther) const
+  {
+    return fX == iOther.fX && fY == iOther.fY && fWidth == iOther.fWidth && fHeight == iOther.fHeight;
+  }
+  bool operator!=(ScissorRect const &iOther) const { return !(*this == iOther); }
+};
+
+//------------------------------------------------------------------------
+// RingRenderer
+//------------------------------------------------------------------------
+class RingRenderer
+{
+public:
+  explicit RingRenderer(ImGui_ImplWGPU_InitInfo const &iInitInfo) :
+    fDevice{iInitInfo.Device},
+    fQueue{wgpuDeviceGetQueue(iInitInfo.Device)},
+    fRenderTargetFormat{iInitInfo.RenderTargetFormat},
+    fDepthStencilFormat{iInitInfo.DepthStencilFormat},
+    fMultisampleState{iInitInfo.PipelineMultisampleState},
+    fNumFramesInFlight{static_cast<uint64_t>(std::max(iInitInfo.NumFramesInFlight, 1))}
+  {
+    wgpuDeviceAddRef(fDevice);
+  }
+
+  ~RingRenderer()
+  {
+    invalidateDeviceObjects();
+    wgpuQueueRelease(fQueue);
+    wgpuDeviceRelease(fDevice);
+  }
+
+  bool hasDeviceObjects() const { return fPipeline != nullptr; }
+  bool createDeviceObjects();
+  void invalidateDeviceObjects();
+  void updateTexture(ImTextureData *iTexture);
+  void renderDrawData(ImDrawData *iDrawData, WGPURenderPassEncoder iPass);
+  void setTextureUploadBudget(size_t iMaxBytesPerFrame) { fTextureUploads.setMaxBytesPerFrame(iMaxBytesPerFrame); }
+  ImGui_ImplWGPURing_Stats const &getStats() const { return fStats; }
+
+private:
+  // consecutive draw commands which can be issued as a single draw call (the indices are rebased so the commands of
+  // different draw lists can be merged as well)
+  struct Batch
+  {
+    ImTextureID fTexture;
+    ScissorRect fScissor;
+    uint32_t fFirstIndex;
+    uint32_t fIndexCount;
+  };
+
+  struct CachedBindGroup
+  {
+    WGPUBindGroup fBindGroup;
+    uint64_t fLastUsedFrame;
+  };
+
+  // every wgpu call crosses into javascript: they are all counted
+  template<typename F, typename... Args>
+  auto call(F iFunction, Args... iArgs) -> decltype(iFunction(iArgs...))
+  {
+    fStats.WGPUCalls++;
+    return iFunction(iArgs...);
+  }
+
+  bool ensureRingCapacity(uint64_t iFrameSize);
+  template<typename T>
+  void packIndices(ImDrawData const *iDrawData, uint8_t *oIndices);
+  void setupRenderState(WGPURenderPassEncoder iPass);
+  void flush(WGPURenderPassEncoder iPass, Batch const &iBatch);
+  WGPUBindGroup getTextureBindGroup(ImTextureID iTexture);
+  void releaseTextureBindGroup(ImTextureID iTexture);
+  void releaseUnusedBindGroups();
+  void destroyTexture(ImTextureData *iTexture);
+  void writeTexture(ImTextureData *iTexture, int iX, int iY, int iWidth, int iHeight, void const *iPixels,
+                    uint32_t iBytesPerRow);
+  void flushTextureUploads();
+
+private:
+  WGPUDevice fDevice;
+  WGPUQueue fQueue;
+  WGPUTextureFormat fRenderTargetFormat;
+  WGPUTextureFormat fDepthStencilFormat;
+  WGPUMultisampleState fMultisampleState;
+  uint64_t fNumFramesInFlight;
+
+  WGPURenderPipeline fPipeline{};
+  WGPUBindGroupLayout fCommonBindGroupLayout{};
+  WGPUBindGroupLayout fTextureBindGroupLayout{};
+  WGPUSampler fSampler{};
+  WGPUBindGroup fCommonBindGroup{};
+  std::unordered_map<ImTextureID, CachedBindGroup> fBindGroups{};
+
+  // one slot per frame in flight, each one holding the data of a frame: [uniforms | vertices | indices]. Frame N
+  // writes to slot N % NumFramesInFlight, so the write of a frame never targets the data still read by the previous
+  // frames (the implementation does not have to order the copy after them)
+  WGPUBuffer fRing{};
+  uint64_t fSlotSize{};
+  std::vector<uint8_t> fStaging{};
+
+  // state of the current frame
+  uint64_t fFrame{};
+  int fFramebufferWidth{};
+  int fFramebufferHeight{};
+  uint64_t fSlotOffset{};
+  WGPUIndexFormat fIndexFormat{WGPUIndexFormat_Uint16};
+  uint64_t fVertexSize{};
+  uint64_t fIndexOffset{};
+  uint64_t fIndexSize{};
+  bool fHasBoundTexture{};
+  ImTextureID fBoundTexture{};
+  bool fHasBoundScissor{};
+  ScissorRect fBoundScissor{};
+
+  // texture updates (glyphs rasterized by ImGui) merged and uploaded within a budget of bytes per frame
+  ImGui_ImplTextureUploads fTextureUploads{};
+
+  ImGui_ImplWGPURing_Stats fStats{};
+};
+
+//------------------------------------------------------------------------
+// RingRenderer::createDeviceObjects
+//------------------------------------------------------------------------
+bool RingRenderer::createDeviceObjects()
+{
+  if(hasDeviceObjects())
+    invalidateDeviceObjects();
+
+  WGPUShaderSourceWGSL wgsl = {};
+  wgsl.chain.sType = WGPUSType_ShaderSourceWGSL;
+  wgsl.code = {kShaderWGSL, WGPU_STRLEN};
+  WGPUShaderModuleDescriptor shaderModuleDescriptor = {};
+  shaderModuleDescriptor.nextInChain = &wgsl.chain;
+  auto shaderModule = call(wgpuDeviceCreateShaderModule, fDevice, &shaderModuleDescriptor);
+
+  // group 0: uniforms + sampler, group 1: texture
+  WGPUBindGroupLayoutEntry commonEntries[2] = {};
+  commonEntries[0].binding = 0;
+  commonEntries[0].visibility = WGPUShaderStage_Vertex | WGPUShaderStage_Fragment;
+  commonEntries[0].buffer.type = WGPUBufferBindingType_Uniform;
+  commonEntries[0].buffer.hasDynamicOffset = true; // the slot of the frame
+  commonEntries[0].buffer.minBindingSize = sizeof(RingUniforms);
+  commonEntries[1].binding = 1;
+  commonEntries[1].visibility = WGPUShaderStage_Fragment;
+  commonEntries[1].sampler.type = WGPUSamplerBindingType_Filtering;
+  WGPUBindGroupLayoutDescriptor commonLayoutDescriptor = {};
+  commonLayoutDescriptor.entryCount = 2;
+  commonLayoutDescriptor.entries = commonEntries;
+  fCommonBindGroupLayout = call(wgpuDeviceCreateBindGroupLayout, fDevice, &commonLayoutDescriptor);
+
+  WGPUBindGroupLayoutEntry textureEntry = {};
+  textureEntry.binding = 0;
+  textureEntry.visibility = WGPUShaderStage_Fragment;
+  textureEntry.texture.sampleType = WGPUTextureSampleType_Float;
+  textureEntry.texture.viewDimension = WGPUTextureViewDimension_2D;
+  WGPUBindGroupLayoutDescriptor textureLayoutDescriptor = {};
+  textureLayoutDescriptor.entryCount = 1;
+  textureLayoutDescriptor.entries = &textureEntry;
+  fTextureBindGroupLayout = call(wgpuDeviceCreateBindGroupLayout, fDevice, &textureLayoutDescriptor);
+
+  WGPUBindGroupLayout bindGroupLayouts[2] = {fCommonBindGroupLayout, fTextureBindGroupLayout};
+  WGPUPipelineLayoutDescriptor pipelineLayoutDescriptor = {};
+  pipelineLayoutDescriptor.bindGroupLayoutCount = 2;
+  pipelineLayoutDescriptor.bindGroupLayouts = bindGroupLayouts;
+  auto pipelineLayout = call(wgpuDeviceCreatePipelineLayout, fDevice, &pipelineLayoutDescriptor);
+
+  WGPUVertexAttribute attributes[3] = {};
+  attributes[0].format = WGPUVertexFormat_Float32x2;
+  attributes[0].offset = offsetof(ImDrawVert, pos);
+  attributes[0].shaderLocation = 0;
+  attributes[1].format = kUVFormat;
+  attributes[1].offset = offsetof(ImDrawVert, uv);
+  attributes[1].shaderLocation = 1;
+  attributes[2].format = WGPUVertexFormat_Unorm8x4;
+  attributes[2].offset = offsetof(ImDrawVert, col);
+  attributes[2].shaderLocation = 2;
+  WGPUVertexBufferLayout vertexBufferLayout = {};
+  vertexBufferLayout.arrayStride = sizeof(ImDrawVert);
+  vertexBufferLayout.stepMode = WGPUVertexStepMode_Vertex;
+  vertexBufferLayout.attributeCount = 3;
+  vertexBufferLayout.attributes = attributes;
+
+  WGPUBlendState blendState = {};
+  blendState.color = {WGPUBlendOperation_Add, WGPUBlendFactor_SrcAlpha, WGPUBlendFactor_OneMinusSrcAlpha};
+  blendState.alpha = {WGPUBlendOperation_Add, WGPUBlendFactor_One, WGPUBlendFactor_OneMinusSrcAlpha};
+  WGPUColorTargetState colorTarget = {};
+  colorTarget.format = fRenderTargetFormat;
+  colorTarget.blend = &blendState;
+  colorTarget.writeMask = WGPUColorWriteMask_All;
+  WGPUFragmentState fragmentState = {};
+  fragmentState.module = shaderModule;
+  fragmentState.entryPoint = {"fs_main", WGPU_STRLEN};
+  fragmentState.targetCount = 1;
+  fragmentState.targets = &colorTarget;
+
+  WGPUDepthStencilState depthStencilState = {};
+  depthStencilState.format = fDepthStencilFormat;
+  depthStencilState.depthWriteEnabled = WGPUOptionalBool_False;
+  depthStencilState.depthCompare = WGPUCompareFunction_Always;
+  depthStencilState.stencilFront = {WGPUCompareFunction_Always, WGPUStencilOperation_Keep,
+                                    WGPUStencilOperation_Keep, WGPUStencilOperation_Keep};
+  depthStencilState.stencilBack = depthStencilState.stencilFront;
+  depthStencilState.stencilReadMask = 0xff;
+  depthStencilState.stencilWriteMask = 0xff;
+
+  WGPURenderPipelineDescriptor pipelineDescriptor = {};
+  pipelineDescriptor.layout = pipelineLayout;
+  pipelineDescriptor.vertex.module = shaderModule;
+  pipelineDescriptor.vertex.entryPoint = {"vs_main", WGPU_STRLEN};
+  pipelineDescriptor.vertex.bufferCount = 1;
+  pipelineDescriptor.vertex.buffers = &vertexBufferLayout;
+  pipelineDescriptor.primitive.topology = WGPUPrimitiveTopology_TriangleList;
+  pipelineDescriptor.primitive.stripIndexFormat = WGPUIndexFormat_Undefined;
+  pipelineDescriptor.primitive.frontFace = WGPUFrontFace_CW;
+  pipelineDescriptor.primitive.cullMode = WGPUCullMode_None;
+  pipelineDescriptor.multisample = fMultisampleState;
+  pipelineDescriptor.fragment = &fragmentState;
+  pipelineDescriptor.depthStencil = fDepthStencilFormat == WGPUTextureFormat_Undefined ? nullptr : &depthStencilState;
+  fPipeline = call(wgpuDeviceCreateRenderPipeline, fDevice, &pipelineDescriptor);
+
+  call(wgpuPipelineLayoutRelease, pipelineLayout);
+  call(wgpuShaderModuleRelease, shaderModule);
+
+  WGPUSamplerDescriptor samplerDescriptor = {};
+  samplerDescriptor.addressModeU = WGPUAddressMode_ClampToEdge;
+  samplerDescriptor.addressModeV = WGPUAddressMode_ClampToEdge;
+  samplerDescriptor.addressModeW = WGPUAddressMode_ClampToEdge;
+  samplerDescriptor.magFilter = WGPUFilterMode_Linear;
+  samplerDescriptor.minFilter = WGPUFilterMode_Linear;
+  samplerDescriptor.mipmapFilter = WGPUMipmapFilterMode_Linear;
+  samplerDescriptor.lodMinClamp = 0.0f;
+  samplerDescriptor.lodMaxClamp = 32.0f;
+  samplerDescriptor.maxAnisotropy = 1;
+  fSampler = call(wgpuDeviceCreateSampler, fDevice, &samplerDescriptor);
+
+  return fPipeline != nullptr && ensureRingCapacity(kInitialSlotSize);
+}
+
+//------------------------------------------------------------------------
+// RingRenderer::invalidateDeviceObjects
+//------------------------------------------------------------------------
+void RingRenderer::invalidateDeviceObjects()
+{
+  // destroys the textures which are only referenced by ImGui (and not by another ImGui context)
+  for(auto texture: ImGui::GetPlatformIO().Textures)
+  {
+    if(texture->RefCount == 1)
+      destroyTexture(texture);
+  }
+
+  for(auto &entry: fBindGroups)
+    call(wgpuBindGroupRelease, entry.second.fBindGroup);
+  fBindGroups.clear();
+  fHasBoundTexture = false;
+
+  if(fCommonBindGroup)
+    call(wgpuBindGroupRelease, fCommonBindGroup);
+  if(fRing)
+    call(wgpuBufferRelease, fRing);
+  if(fSampler)
+    call(wgpuSamplerRelease, fSampler);
+  if(fPipeline)
+    call(wgpuRenderPipelineRelease, fPipeline);
+  if(fTextureBindGroupLayout)
+    call(wgpuBindGroupLayoutRelease, fTextureBindGroupLayout);
+  if(fCommonBindGroupLayout)
+    call(wgpuBindGroupLayoutRelease, fCommonBindGroupLayout);
+
+  fCommonBindGroup = nullptr;
+  fRing = nullptr;
+  fSlotSize = 0;
+  fSampler = nullptr;
+  fPipeline = nullptr;
+  fTextureBindGroupLayout = nullptr;
+  fCommonBindGroupLayout = nullptr;
+}
+
+//------------------------------------------------------------------------
+// RingRenderer::ensureRingCapacity
+//------------------------------------------------------------------------
+bool RingRenderer::ensureRingCapacity(uint64_t iFrameSize)
+{
+  if(fRing && iFrameSize <= fSlotSize)
+    return true;
+
+  // all the slots have the same size (a power of 2, so a multiple of kSlotAlignment)
+  auto slotSize = std::max(fSlotSize, kInitialSlotSize);
+  while(slotSize < iFrameSize)
+    slotSize *= 2;
+
+  // the frames in flight keep using the previous buffer (release only drops this reference)
+  if(fRing)
+  {
+    call(wgpuBufferRelease, fRing);
+    call(wgpuBindGroupRelease, fCommonBindGroup);
+    fStats.RingGrowths++;
+  }
+
+  WGPUBufferDescriptor bufferDescriptor = {};
+  bufferDescriptor.usage = WGPUBufferUsage_CopyDst | WGPUBufferUsage_Uniform | WGPUBufferUsage_Vertex |
+                           WGPUBufferUsage_Index;
+  bufferDescriptor.size = slotSize * fNumFramesInFlight;
+  fRing = call(wgpuDeviceCreateBuffer, fDevice, &bufferDescriptor);
+  fSlotSize = slotSize;
+  fStats.RingSize = static_cast<size_t>(bufferDescriptor.size);
+
+  // the common bind group references the ring (the offset of the slot is given when setting it)
+  WGPUBindGroupEntry entries[2] = {};
+  entries[0].binding = 0;
+  entries[0].buffer = fRing;
+  entries[0].offset = 0;
+  entries[0].size = sizeof(RingUniforms);
+  entries[1].binding = 1;
+  entries[1].sampler = fSampler;
+  WGPUBindGroupDescriptor bindGroupDescriptor = {};
+  bindGroupDescriptor.layout = fCommonBindGroupLayout;
+  bindGroupDescriptor.entryCount = 2;
+  bindGroupDescriptor.entries = entries;
+  fCommonBindGroup = call(wgpuDeviceCreateBindGroup, fDevice, &bindGroupDescriptor);
+  fStats.BindGroupsCreated++;
+
+  return fRing != nullptr && fCommonBindGroup != nullptr;
+}
+
+//------------------------------------------------------------------------
+// RingRenderer::updateTexture
+//------------------------------------------------------------------------
+void RingRenderer::updateTexture(ImTextureData *iTexture)
+{
+  if(iTexture->Status == ImTextureStatus_WantCreate)
+  {
+    IM_ASSERT(iTexture->TexID == ImTextureID_Invalid && iTexture->BackendUserData == nullptr);
+    IM_ASSERT(iTexture->Format == ImTextureFormat_RGBA32);
+    WGPUTextureDescriptor textureDescriptor = {};
+    textureDescriptor.usage = WGPUTextureUsage_CopyDst | WGPUTextureUsage_TextureBinding;
+    textureDescriptor.dimension = WGPUTextureDimension_2D;
+    textureDescriptor.size = {static_cast<uint32_t>(iTexture->Width), static_cast<uint32_t>(iTexture->Height), 1};
+    textureDescriptor.format = WGPUTextureFormat_RGBA8Unorm;
+    textureDescriptor.mipLevelCount = 1;
+    textureDescriptor.sampleCount = 1;
+    auto texture = call(wgpuDeviceCreateTexture, fDevice, &textureDescriptor);
+    auto view = call(wgpuTextureCreateView, texture, nullptr);
+    iTexture->BackendUserData = texture;
+    iTexture->SetTexID(static_cast<ImTextureID>(reinterpret_cast<intptr_t>(view)));
+  }
+
+  if(iTexture->Status == ImTextureStatus_WantCreate)
+  {
+    // the full texture
+    fTextureUploads.forget(iTexture);
+    writeTexture(iTexture, 0, 0, iTexture->Width, iTexture->Height, iTexture->GetPixels(),
+                 static_cast<uint32_t>(iTexture->GetPitch()));
+    iTexture->SetStatus(ImTextureStatus_OK);
+  }
+  else if(iTexture->Status == ImTextureStatus_WantUpdates)
+  {
+    // uploaded by flushTextureUploads (merged with the pending updates, within the budget)
+    fTextureUploads.enqueue(iTexture);
+  }
+
+  // the frames in flight keep using the texture (release only drops this reference)
+  if(iTexture->Status == ImTextureStatus_WantDestroy)
+    destroyTexture(iTexture);
+}
+
+//------------------------------------------------------------------------
+// RingRenderer::destroyTexture
+//------------------------------------------------------------------------
+void RingRenderer::destroyTexture(ImTextureData *iTexture)
+{
+  fTextureUploads.forget(iTexture);
+  if(iTexture->TexID != ImTextureID_Invalid)
+  {
+    releaseTextureBindGroup(iTexture->TexID);
+    call(wgpuTextureViewRelease, reinterpret_cast<WGPUTextureView>(static_cast<intptr_t>(iTexture->TexID)));
+  }
+  if(iTexture->BackendUserData)
+    call(wgpuTextureRelease, static_cast<WGPUTexture>(iTexture->BackendUserData));
+
+  iTexture->SetTexID(ImTextureID_Invalid);
+  iTexture->SetStatus(ImTextureStatus_Destroyed);
+  iTexture->BackendUserData = nullptr;
+}
+
+//------------------------------------------------------------------------
+// RingRenderer::writeTexture
+//------------------------------------------------------------------------
+void RingRenderer::writeTexture(ImTextureData *iTexture, int iX, int iY, int iWidth, int iHeight,
+                                void const *iPixels, uint32_t iBytesPerRow)
+{
+  WGPUTexelCopyTextureInfo destination = {};
+  destination.texture = static_cast<WGPUTexture>(iTexture->BackendUserData);
+  destination.mipLevel = 0;
+  destination.origin = {static_cast<uint32_t>(iX), static_cast<uint32_t>(iY), 0};
+  destination.aspect = WGPUTextureAspect_All;
+  WGPUTexelCopyBufferLayout layout = {};
+  layout.offset = 0;
+  layout.bytesPerRow = iBytesPerRow;
+  layout.rowsPerImage = static_cast<uint32_t>(iHeight);
+  WGPUExtent3D size = {static_cast<uint32_t>(iWidth), static_cast<uint32_t>(iHeight), 1};
+  auto dataSize = static_cast<size_t>(iBytesPerRow) * (iHeight - 1) +
+                  static_cast<size_t>(iWidth) * iTexture->BytesPerPixel;
+  call(wgpuQueueWriteTexture, fQueue, &destination, iPixels, dataSize, &layout, &size);
+}
+
+//------------------------------------------------------------------------
+// RingRenderer::flushTextureUploads
+//------------------------------------------------------------------------
+void RingRenderer::flushTextureUploads()
+{
+  // the rows are packed in the staging buffer: wgpuQueueWriteTexture copies the data between the rows (the rest of
+  // the texture pitch) when given the texture pixels directly
+  fStats.TextureUploadBytes = fTextureUploads.flush([this](ImGui_ImplTextureUploads::Upload const &iUpload) {
+    writeTexture(iUpload.fTexture, iUpload.fX, iUpload.fY, iUpload.fWidth, iUpload.fHeight,
+                 fTextureUploads.stage(iUpload),
+                 static_cast<uint32_t>(iUpload.fWidth * iUpload.fTexture->BytesPerPixel));
+    fStats.TextureUploads++;
+  });
+  fStats.TexturePendingBytes = fTextureUploads.getPendingBytes();
+}
+
+//------------------------------------------------------------------------
+// RingRenderer::getTextureBindGroup
+//------------------------------------------------------------------------
+WGPUBindGroup RingRenderer::getTextureBindGroup(ImTextureID iTexture)
+{
+  auto iter = fBindGroups.find(iTexture);
+  if(iter == fBindGroups.end())
+  {
+    WGPUBindGroupEntry entry = {};
+    entry.binding = 0;
+    entry.textureView = reinterpret_cast<WGPUTextureView>(static_cast<intptr_t>(iTexture));
+    WGPUBindGroupDescriptor bindGroupDescriptor = {};
+    bindGroupDescriptor.layout = fTextureBindGroupLayout;
+    bindGroupDescriptor.entryCount = 1;
+    bindGroupDescriptor.entries = &entry;
+    auto bindGroup = call(wgpuDeviceCreateBindGroup, fDevice, &bindGroupDescriptor);
+    fStats.BindGroupsCreated++;
+    iter = fBindGroups.emplace(iTexture, CachedBindGroup{bindGroup, fFrame}).first;
+  }
+  iter->second.fLastUsedFrame = fFrame;
+  return iter->second.fBindGroup;
+}
+
+//------------------------------------------------------------------------
+// RingRenderer::releaseTextureBindGroup
+//------------------------------------------------------------------------
+void RingRenderer::releaseTextureBindGroup(ImTextureID iTexture)
+{
+  auto iter = fBindGroups.find(iTexture);
+  if(iter != fBindGroups.end())
+  {
+    call(wgpuBindGroupRelease, iter->second.fBindGroup);
+    fBindGroups.erase(iter);
+  }
+  if(fHasBoundTexture && fBoundTexture == iTexture)
+    fHasBoundTexture = false;
+}
+
+//------------------------------------------------------------------------
+// RingRenderer::releaseUnusedBindGroups
+//------------------------------------------------------------------------
+void RingRenderer::releaseUnusedBindGroups()
+{
+  for(auto iter = fBindGroups.begin(); iter != fBindGroups.end();)
+  {
+    if(fFrame - iter->second.fLastUsedFrame > kBindGroupMaxAge)
+    {
+      call(wgpuBindGroupRelease, iter->second.fBindGroup);
+      iter = fBindGroups.erase(iter);
+    }
+    else
+      ++iter;
+  }
+}
+
+//------------------------------------------------------------------------
+// RingRenderer::setupRenderState
+//------------------------------------------------------------------------
+void RingRenderer::setupRenderState(WGPURenderPassEncoder iPass)
+{
+  call(wgpuRenderPassEncoderSetViewport, iPass, 0.0f, 0.0f, static_cast<float>(fFramebufferWidth),
+       static_cast<float>(fFramebufferHeight), 0.0f, 1.0f);
+  call(wgpuRenderPassEncoderSetPipeline, iPass, fPipeline);
+  call(wgpuRenderPassEncoderSetVertexBuffer, iPass, 0, fRing, fSlotOffset + kVerticesOffset, fVertexSize);
+  call(wgpuRenderPassEncoderSetIndexBuffer, iPass, fRing, fIndexFormat, fSlotOffset + fIndexOffset, fIndexSize);
+  auto uniformsOffset = static_cast<uint32_t>(fSlotOffset);
+  call(wgpuRenderPassEncoderSetBindGroup, iPass, 0, fCommonBindGroup, 1, &uniformsOffset);
+  fHasBoundTexture = false;
+  fHasBoundScissor = false;
+}
+
+//------------------------------------------------------------------------
+// RingRenderer::flush
+//------------------------------------------------------------------------
+void RingRenderer::flush(WGPURenderPassEncoder iPass, Batch const &iBatch)
+{
+  if(!fHasBoundTexture || fBoundTexture != iBatch.fTexture)
+  {
+    call(wgpuRenderPassEncoderSetBindGroup, iPass, 1, getTextureBindGroup(iBatch.fTexture), 0, nullptr);
+    // (the texture is bound at least once per frame since setupRenderState resets the state, which keeps the bind
+    // group alive, see releaseUnusedBindGroups)
+    fBoundTexture = iBatch.fTexture;
+    fHasBoundTexture = true;
+  }
+
+  if(!fHasBoundScissor || fBoundScissor != iBatch.fScissor)
+  {
+    call(wgpuRenderPassEncoderSetScissorRect, iPass, iBatch.fScissor.fX, iBatch.fScissor.fY, iBatch.fScissor.fWidth,
+         iBatch.fScissor.fHeight);
+    fBoundScissor = iBatch.fScissor;
+    fHasBoundScissor = true;
+  }
+
+  call(wgpuRenderPassEncoderDrawIndexed, iPass, iBatch.fIndexCount, 1, iBatch.fFirstIndex, 0, 0);
+  fStats.DrawCalls++;
+}
+
+//------------------------------------------------------------------------
+// RingRenderer::packIndices
+// Copies the indices of all the draw lists, rebased on the vertices of the frame (instead of the vertices of their
+// draw list), so that a single range of indices is drawn with a base vertex of 0 and the commands of different draw
+// lists can be merged into a single draw call.
+//------------------------------------------------------------------------
+template<typename T>
+void RingRenderer::packIndices(ImDrawData const *iDrawData, uint8_t *oIndices)
+{
+  auto indices = reinterpret_cast<T *>(oIndices);
+  uint32_t globalVertexOffset = 0;
+  for(auto list: iDrawData->CmdLists)
+  {
+    for(auto const &cmd: list->CmdBuffer)
+    {
+      if(cmd.UserCallback != nullptr)
+        continue;
+      auto src = list->IdxBuffer.Data + cmd.IdxOffset;
+      auto dst = indices + cmd.IdxOffset;
+      auto base = globalVertexOffset + cmd.VtxOffset;
+      for(unsigned int i = 0; i < cmd.ElemCount; i++)
+        dst[i] = static_cast<T>(src[i] + base);
+    }
+    indices += list->IdxBuffer.Size;
+    globalVertexOffset += static_cast<uint32_t>(list->VtxBuffer.Size);
+  }
+}
+
+//------------------------------------------------------------------------
+// RingRenderer::renderDrawData
+//------------------------------------------------------------------------
+void RingRenderer::renderDrawData(ImDrawData *iDrawData, WGPURenderPassEncoder iPass)
+{
+  fStats.DrawCommands = 0;
+  fStats.DrawCalls = 0;
+  fStats.WGPUCalls = 0;
+  fStats.BufferWrites = 0;
+  fStats.UploadBytes = 0;
+  fStats.TextureUploads = 0;
+  fStats.TextureUploadBytes = 0;
+
+  // avoid rendering when minimized
+  fFramebufferWidth = static_cast<int>(iDrawData->DisplaySize.x * iDrawData->FramebufferScale.x);
+  fFramebufferHeight = static_cast<int>(iDrawData->DisplaySize.y * iDrawData->FramebufferScale.y);
+  if(fFramebufferWidth <= 0 || fFramebufferHeight <= 0 || iDrawData->CmdListsCount == 0)
+    return;
+
+  // catch up with texture updates (most of the time, the list will have 1 element with an OK status)
+  if(iDrawData->Textures)
+  {
+    for(auto texture: *iDrawData->Textures)
+    {
+      if(texture->Status != ImTextureStatus_OK)
+        updateTexture(texture);
+    }
+  }
+  flushTextureUploads();
+
+  if(iDrawData->TotalVtxCount == 0 || iDrawData->TotalIdxCount == 0)
+    return;
+
+  // the rebased indices fit in 16 bits as long as the frame has no more than 64K vertices (independently of
+  // ImDrawIdx)
+  auto indexSize = iDrawData->TotalVtxCount <= 0x10000 ? sizeof(uint16_t) : sizeof(uint32_t);
+  fIndexFormat = indexSize == sizeof(uint16_t) ? WGPUIndexFormat_Uint16 : WGPUIndexFormat_Uint32;
+
+  // a write must be a multiple of 4 bytes (sizeof(ImDrawVert) is)
+  fVertexSize = static_cast<uint64_t>(iDrawData->TotalVtxCount) * sizeof(ImDrawVert);
+  fIndexOffset = kVerticesOffset + fVertexSize;
+  fIndexSize = alignUp(static_cast<uint64_t>(iDrawData->TotalIdxCount) * indexSize, 4);
+  auto frameSize = fIndexOffset + fIndexSize;
+  if(!ensureRingCapacity(frameSize))
+    return;
+
+  fFrame++;
+  fSlotOffset = (fFrame % fNumFramesInFlight) * fSlotSize;
+
+  // packs the uniforms, vertices and indices of the frame so that they are uploaded with a single write
+  fStaging.resize(static_cast<size_t>(frameSize));
+  {
+    float L = iDrawData->DisplayPos.x;
+    float R = iDrawData->DisplayPos.x + iDrawData->DisplaySize.x;
+    float T = iDrawData->DisplayPos.y;
+    float B = iDrawData->DisplayPos.y + iDrawData->DisplaySize.y;
+    RingUniforms uniforms = {
+      {
+        {2.0f / (R - L), 0.0f, 0.0f, 0.0f},
+        {0.0f, 2.0f / (T - B), 0.0f, 0.0f},
+        {0.0f, 0.0f, 0.5f, 0.0f},
+        {(R + L) / (L - R), (T + B) / (B - T), 0.5f, 1.0f},
+      },
+      // the shader outputs linear colors which must be converted when the render target is sRGB
+      fRenderTargetFormat == WGPUTextureFormat_RGBA8UnormSrgb ||
+      fRenderTargetFormat == WGPUTextureFormat_BGRA8UnormSrgb ? 2.2f : 1.0f,
+      {}
+    };
+    std::memcpy(fStaging.data(), &uniforms, sizeof(uniforms));
+  }
+  auto vertices = fStaging.data() + kVerticesOffset;
+  for(auto list: iDrawData->CmdLists)
+  {
+    auto vertexBytes = static_cast<size_t>(list->VtxBuffer.Size) * sizeof(ImDrawVert);
+    std::memcpy(vertices, list->VtxBuffer.Data, vertexBytes);
+    vertices += vertexBytes;
+  }
+  if(fIndexFormat == WGPUIndexFormat_Uint16)
+    packIndices<uint16_t>(iDrawData, fStaging.data() + fIndexOffset);
+  else
+    packIndices<uint32_t>(iDrawData, fStaging.data() + fIndexOffset);
+  call(wgpuQueueWriteBuffer, fQueue, fRing, fSlotOffset, fStaging.data(), fStaging.size());
+  fStats.BufferWrites++;
+  fStats.UploadBytes += fStaging.size();
+
+  setupRenderState(iPass);
+
+  // exposes the render state to the draw callbacks
+  ImGui_ImplWGPU_RenderState renderState;
+  renderState.Device = fDevice;
+  renderState.RenderPassEncoder = iPass;
+  ImGui::GetPlatformIO().Renderer_RenderState = &renderState;
+
+  auto clipOffset = iDrawData->DisplayPos;         // (0,0) unless using multi-viewports
+  auto clipScale = iDrawData->FramebufferScale;    // (1,1) unless using retina display which are often (2,2)
+  uint32_t globalIndexOffset = 0;
+  Batch batch{};
+  bool hasBatch = false;
+  for(auto list: iDrawData->CmdLists)
+  {
+    for(auto const &cmd: list->CmdBuffer)
+    {
+      fStats.DrawCommands++;
+
+      if(cmd.UserCallback != nullptr)
+      {
+        if(hasBatch)
+          flush(iPass, batch);
+        hasBatch = false;
+        if(cmd.UserCallback == ImDrawCallback_ResetRenderState)
+          setupRenderState(iPass);
+        else
+        {
+          cmd.UserCallback(list, &cmd);
+          // the callback may have changed any state
+          fHasBoundTexture = false;
+          fHasBoundScissor = false;
+        }
+        continue;
+      }
+
+      // projects the clip rectangle into framebuffer space (and clamps it, as WebGPU requires)
+      ImVec2 clipMin((cmd.ClipRect.x - clipOffset.x) * clipScale.x, (cmd.ClipRect.y - clipOffset.y) * clipScale.y);
+      ImVec2 clipMax((cmd.ClipRect.z - clipOffset.x) * clipScale.x, (cmd.ClipRect.w - clipOffset.y) * clipScale.y);
+      clipMin.x = std::max(clipMin.x, 0.0f);
+      clipMin.y = std::max(clipMin.y, 0.0f);
+      clipMax.x = std::min(clipMax.x, static_cast<float>(fFramebufferWidth));
+      clipMax.y = std::min(clipMax.y, static_cast<float>(fFramebufferHeight));
+      if(clipMax.x <= clipMin.x || clipMax.y <= clipMin.y)
+        continue;
+
+      ScissorRect scissor{static_cast<uint32_t>(clipMin.x), static_cast<uint32_t>(clipMin.y),
+                          static_cast<uint32_t>(clipMax.x - clipMin.x), static_cast<uint32_t>(clipMax.y - clipMin.y)};
+      auto texture = cmd.GetTexID();
+      auto firstIndex = globalIndexOffset + cmd.IdxOffset;
+
+      // merges with the previous command (of the same draw list or not) when it draws the indices right before with
+      // the same state
+      if(hasBatch && batch.fTexture == texture && batch.fScissor == scissor &&
+         batch.fFirstIndex + batch.fIndexCount == firstIndex)
+      {
+        batch.fIndexCount += cmd.ElemCount;
+      }
+      else
+      {
+        if(hasBatch)
+          flush(iPass, batch);
+        batch = Batch{texture, scissor, firstIndex, cmd.ElemCount};
+        hasBatch = true;
+      }
+    }
+    globalIndexOffset += static_cast<uint32_t>(list->IdxBuffer.Size);
+  }
+  if(hasBatch)
+    flush(iPass, batch);
+
+  ImGui::GetPlatformIO().Renderer_RenderState = nullptr;
+
+  releaseUnusedBindGroups();
+}
+
+RingRenderer *GetRingRenderer()
+{
+  return ImGui::GetCurrentContext() ? static_cast<RingRenderer *>(ImGui::GetIO().BackendRendererUserData) : nullptr;
+}
+
+}
+
+//------------------------------------------------------------------------
+// ImGui_ImplWGPU API (same as the stock backend)
+//------------------------------------------------------------------------
+bool ImGui_ImplWGPU_Init(ImGui_ImplWGPU_InitInfo *init_info)
+{
+  ImGuiIO &io = ImGui::GetIO();
+  IMGUI_CHECKVERSION();
+  IM_ASSERT(io.BackendRendererUserData == nullptr && "Already initialized a renderer backend!");
+
+  io.BackendRendererUserData = new RingRenderer(*init_info);
+  io.BackendRendererName = "imgui_impl_wgpu_ring";
+  io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset; // We can honor the ImDrawCmd::VtxOffset field, allowing for large meshes.
+  io.BackendFlags |= ImGuiBackendFlags_RendererHasTextures;  // We can honor ImGuiPlatformIO::Textures[] requests during render.
+  return true;
+}
+
+void ImGui_ImplWGPU_Shutdown()
+{
+  auto renderer = GetRingRenderer();
+  IM_ASSERT(renderer != nullptr && "No renderer backend to shutdown, or already shutdown?");
+  ImGuiIO &io = ImGui::GetIO();
+
+  delete renderer;
+  io.BackendRendererName = nullptr;
+  io.BackendRendererUserData = nullptr;
+  io.BackendFlags &= ~(ImGuiBackendFlags_RendererHasVtxOffset | ImGuiBackendFlags_RendererHasTextures);
+}
+
+void ImGui_ImplWGPU_NewFrame()
+{
+  auto renderer = GetRingRenderer();
+  IM_ASSERT(renderer != nullptr && "Context or backend not initialized! Did you call ImGui_ImplWGPU_Init()?");
+  if(!renderer->hasDeviceObjects())
+  {
+    auto created = renderer->createDeviceObjects();
+    IM_ASSERT(created && "ImGui_ImplWGPU_CreateDeviceObjects() failed!");
+    IM_UNUSED(created);
+  }
+}
+
+void ImGui_ImplWGPU_RenderDrawData(ImDrawData *draw_data, WGPURenderPassEncoder pass_encoder)
+{
+  GetRingRenderer()->renderDrawData(draw_data, pass_encoder);
+}
+
+void ImGui_ImplWGPU_UpdateTexture(ImTextureData *tex)
+{
+  GetRingRenderer()->updateTexture(tex);
+}
+
+bool ImGui_ImplWGPU_CreateDeviceObjects()
+{
+  return GetRingRenderer()->createDeviceObjects();
+}
+
+void ImGui_ImplWGPU_InvalidateDeviceObjects()
+{
+  GetRingRenderer()->invalidateDeviceObjects();
+}
+
+void ImGui_ImplWGPURing_SetTextureUploadBudget(size_t max_bytes_per_frame)
+{
+  GetRingRenderer()->setTextureUploadBudget(max_bytes_per_frame);
+}
+
+ImGui_ImplWGPURing_Stats ImGui_ImplWGPURing_GetStats()
+{
+  auto renderer = GetRingRenderer();
+  return renderer ? renderer->getStats() : ImGui_ImplWGPURing_Stats{};
+}
+
+//------------------------------------------------------------------------
+// Helpers declared by backends/imgui_impl_wgpu.h (independent of the renderer, used by the applications). The port
+// always builds the WebGPU renderers with emdawnwebgpu (IMGUI_IMPL_WEBGPU_BACKEND_DAWN).
+//------------------------------------------------------------------------
+#ifndef IMGUI_IMPL_WEBGPU_BACKEND_DAWN
+#error "renderer=wgpu-ring requires emdawnwebgpu (IMGUI_IMPL_WEBGPU_BACKEND_DAWN)"
+#endif
+
+bool ImGui_ImplWGPU_IsSurfaceStatusError(WGPUSurfaceGetCurrentTextureStatus status)
+{
+  return status == WGPUSurfaceGetCurrentTextureStatus_Error;
+}
+
+bool ImGui_ImplWGPU_IsSurfaceStatusSubOptimal(WGPUSurfaceGetCurrentTextureStatus status)
+{
+  return status == WGPUSurfaceGetCurrentTextureStatus_Timeout ||
+         status == WGPUSurfaceGetCurrentTextureStatus_Outdated ||
+         status == WGPUSurfaceGetCurrentTextureStatus_Lost ||
+         status == WGPUSurfaceGetCurrentTextureStatus_SuccessSuboptimal;
+}
+
+void ImGui_ImplWGPU_DebugPrintAdapterInfo(const WGPUAdapter &adapter)
+{
+  WGPUAdapterInfo info = {};
+  wgpuAdapterGetInfo(adapter, &info);
+  printf("description: \"%.*s\"\n", static_cast<int>(info.description.length), info.description.data);
+  printf("vendor: \"%.*s\", vendorID: %x\n", static_cast<int>(info.vendor.length), info.vendor.data, info.vendorID);
+  printf("architecture: \"%.*s\"\n", static_cast<int>(info.architecture.length), info.architecture.data);
+  printf("device: \"%.*s\", deviceID: %x\n", static_cast<int>(info.device.length), info.device.data, info.deviceID);
+  printf("backendType: \"%s\"\n", ImGui_ImplWGPU_GetBackendTypeName(info.backendType));
+  printf("adapterType: \"%s\"\n", ImGui_ImplWGPU_GetAdapterTypeName(info.adapterType));
+  wgpuAdapterInfoFreeMembers(info);
+}
+
+const char *ImGui_ImplWGPU_GetBackendTypeName(WGPUBackendType type)
+{
+  switch(type)
+  {
+    case WGPUBackendType_WebGPU: return "WebGPU";
+    case WGPUBackendType_D3D11: return "D3D11";
+    case WGPUBackendType_D3D12: return "D3D12";
+    case WGPUBackendType_Metal: return "Metal";
+    case WGPUBackendType_Vulkan: return "Vulkan";
+    case WGPUBackendType_OpenGL: return "OpenGL";
+    case WGPUBackendType_OpenGLES: return "OpenGLES";
+    default: return "unknown";
+  }
+}
+
+const char *ImGui_ImplWGPU_GetAdapterTypeName(WGPUAdapterType type)
+{
+  switch(type)
+  {
+    case WGPUAdapterType_DiscreteGPU: return "DiscreteGPU";
+    case WGPUAdapterType_IntegratedGPU: return "IntegratedGPU";
+    case WGPUAdapterType_CPU: return "CPU";
+    default: return "unknown";
+  }
+}
+
+const char *ImGui_ImplWGPU_GetDeviceLostReasonName(WGPUDeviceLostReason type)
+{
+  switch(type)
+  {
+    case WGPUDeviceLostReason_Destroyed: return "Destroyed";
+    case WGPUDeviceLostReason_FailedCreation: return "FailedCreation";
+    default: return "Unknown";
+  }
+}
+
+const char *ImGui_ImplWGPU_GetErrorTypeName(WGPUErrorType type)
+{
+  switch(type)
+  {
+    case WGPUErrorType_Validation: return "Validation";
+    case WGPUErrorType_OutOfMemory: return "OutOfMemory";
+    case WGPUErrorType_Internal: return "Internal";
+    default: return "Unknown";
+  }
+}
+
+#endif // #ifndef IMGUI_DISABLE
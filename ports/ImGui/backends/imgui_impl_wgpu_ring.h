@@ -0,0 +1,50 @@
+// Alternate WebGPU renderer for ImGui (renderer=wgpu-ring)
+//
+// Drop-in replacement of the stock backends/imgui_impl_wgpu.cpp: it implements the same API (ImGui_ImplWGPU_Init,
+// ImGui_ImplWGPU_RenderDrawData, ...) declared in backends/imgui_impl_wgpu.h, so the application code does not
+// change. The differences are in how a frame is submitted:
+// - the uniforms, vertices and indices of a frame are packed in a single upload (1 wgpuQueueWriteBuffer) into a
+//   persistent ring buffer (only reallocated when a frame does not fit), which has one slot per frame in flight
+//   (ImGui_ImplWGPU_InitInfo::NumFramesInFlight)
+// - the vertex/index buffers and the common bind group are set once per frame
+// - the texture bind groups are cached per texture, and only set when the texture changes
+// - the indices are rebased on the vertices of the frame, so consecutive draw commands sharing the same texture and
+//   scissor rectangle are merged into a single draw call, even when they belong to different draw lists
+// - the texture updates (glyphs rasterized by ImGui) are merged and uploaded within a budget of bytes per frame (see
+//   imgui_texture_uploads.h), so that a burst of new glyphs is spread over several frames
+//
+// This header only adds the upload budget and the statistics used to compare both renderers (each wgpu call crosses
+// into javascript).
+
+#pragma once
+
+#include "imgui.h"
+#ifndef IMGUI_DISABLE
+
+#include <stddef.h>
+
+struct ImGui_ImplWGPURing_Stats
+{
+  // last frame (ImGui_ImplWGPU_RenderDrawData)
+  int DrawCommands;           // number of ImDrawCmd (the stock renderer issues one draw call per command)
+  int DrawCalls;              // number of draw calls issued after merging
+  int WGPUCalls;              // number of wgpu* calls (including the texture updates)
+  int BufferWrites;           // number of wgpuQueueWriteBuffer calls
+  size_t UploadBytes;         // number of bytes written to the ring buffer
+  int TextureUploads;         // number of wgpuQueueWriteTexture for texture updates (after merging)
+  size_t TextureUploadBytes;  // number of bytes of texture updates uploaded
+  size_t TexturePendingBytes; // number of bytes of texture updates deferred to the next frames
+
+  // since ImGui_ImplWGPU_Init
+  int BindGroupsCreated;
+  int RingGrowths;            // number of times the ring buffer had to be reallocated
+  size_t RingSize;            // current size of the ring buffer (all the slots)
+};
+
+// Maximum number of bytes of texture updates uploaded per frame (256 KB by default, 0 for no limit). The updates
+// which do not fit are uploaded during the next frames. Must be called after ImGui_ImplWGPU_Init.
+IMGUI_IMPL_API void ImGui_ImplWGPURing_SetTextureUploadBudget(size_t max_bytes_per_frame);
+
+IMGUI_IMPL_API ImGui_ImplWGPURing_Stats ImGui_ImplWGPURing_GetStats();
+
+#endif // #ifndef IMGUI_DISABLE
@@ -0,0 +1,169 @@
+// Texture upload scheduler shared by the renderers provided by this port (webgl2, wgpu-ring)
+//
+// ImGui updates its font atlas at runtime: every glyph rasterized (new glyph, new size) is a small rectangle of the
+// texture to upload (ImTextureData::Updates). The stock renderers upload the rectangle bounding all the updates of a
+// frame, which during a burst (zoom, text in a new language) can be most of the texture, in a single frame. Instead,
+// the scheduler:
+// - takes the updates of a texture (whose status is then set to OK) and merges them with the pending rectangles of
+//   the same texture, as long as the merged rectangle does not waste more than kMergeWaste of its area
+// - uploads the pending rectangles (oldest first) up to a budget of bytes per frame, and defers the rest to the next
+//   frames (a rectangle larger than the budget is uploaded by bands of rows). Until then, a new glyph is drawn with
+//   the previous content of its rectangle (usually empty)
+// - copies the rows of a rectangle in a staging buffer reused from one frame to the next, for the APIs which would
+//   otherwise transfer the whole pitch of the texture for each row (wgpuQueueWriteTexture)
+//
+// The pixels are read from the texture (ImTextureData::Pixels) when uploaded, so a deferred rectangle is always
+// uploaded with its latest content.
+
+#pragma once
+
+#include "imgui.h"
+#ifndef IMGUI_DISABLE
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+class ImGui_ImplTextureUploads
+{
+public:
+  // a merged rectangle can be up to 25% bigger than the sum of the rectangles it contains
+  static constexpr float kMergeWaste = 1.25f;
+  static constexpr size_t kDefaultMaxBytesPerFrame = 256 * 1024;
+
+  struct Upload
+  {
+    ImTextureData *fTexture;
+    int fX, fY, fWidth, fHeight;
+
+    size_t getBytes() const { return static_cast<size_t>(fWidth) * fHeight * fTexture->BytesPerPixel; }
+  };
+
+  // 0 for no limit (everything is uploaded during the frame it was requested)
+  void setMaxBytesPerFrame(size_t iMaxBytesPerFrame) { fMaxBytesPerFrame = iMaxBytesPerFrame; }
+
+  // Takes the updates requested by ImGui for the texture (status ImTextureStatus_WantUpdates)
+  void enqueue(ImTextureData *iTexture)
+  {
+    IM_ASSERT(iTexture->Status == ImTextureStatus_WantUpdates);
+    if(iTexture->Updates.Size == 0)
+      add({iTexture, iTexture->UpdateRect.x, iTexture->UpdateRect.y, iTexture->UpdateRect.w, iTexture->UpdateRect.h});
+    for(auto const &rect: iTexture->Updates)
+      add({iTexture, rect.x, rect.y, rect.w, rect.h});
+    iTexture->SetStatus(ImTextureStatus_OK);
+  }
+
+  // Drops the pending rectangles of the texture (when it is created, with all its content, or destroyed)
+  void forget(ImTextureData *iTexture)
+  {
+    fPending.erase(std::remove_if(fPending.begin(), fPending.end(),
+                                  [iTexture](Upload const &u) { return u.fTexture == iTexture; }),
+                   fPending.end());
+  }
+
+  void clear() { fPending.clear(); }
+
+  // Calls iUploadFunction(Upload const &) for the pending rectangles, up to the budget (at least one row per frame).
+  // Returns the number of bytes uploaded.
+  template<typename UploadFunction>
+  size_t flush(UploadFunction &&iUploadFunction)
+  {
+    auto budget = fMaxBytesPerFrame == 0 ? SIZE_MAX : fMaxBytesPerFrame;
+    size_t bytes = 0;
+    size_t done = 0;
+    for(; done < fPending.size(); done++)
+    {
+      auto &pending = fPending[done];
+      auto rowBytes = static_cast<size_t>(pending.fWidth) * pending.fTexture->BytesPerPixel;
+      auto remaining = budget > bytes ? budget - bytes : 0;
+      if(bytes > 0 && remaining < rowBytes)
+        break;
+      auto rows = std::min<size_t>(pending.fHeight, std::max<size_t>(1, remaining / std::max<size_t>(1, rowBytes)));
+      iUploadFunction(Upload{pending.fTexture, pending.fX, pending.fY, pending.fWidth, static_cast<int>(rows)});
+      bytes += rows * rowBytes;
+      if(static_cast<int>(rows) < pending.fHeight)
+      {
+        // the next rows are uploaded during the next frame(s)
+        pending.fY += static_cast<int>(rows);
+        pending.fHeight -= static_cast<int>(rows);
+        break;
+      }
+    }
+    fPending.erase(fPending.begin(), fPending.begin() + static_cast<std::ptrdiff_t>(done));
+    return bytes;
+  }
+
+  // Copies the pixels of the upload (tightly packed rows) into the staging buffer, which is reused by the next calls
+  unsigned char const *stage(Upload const &iUpload)
+  {
+    auto rowBytes = static_cast<size_t>(iUpload.fWidth) * iUpload.fTexture->BytesPerPixel;
+    if(fStaging.size() < rowBytes * iUpload.fHeight)
+      fStaging.resize(rowBytes * iUpload.fHeight);
+    for(int y = 0; y < iUpload.fHeight; y++)
+      memcpy(fStaging.data() + y * rowBytes, iUpload.fTexture->GetPixelsAt(iUpload.fX, iUpload.fY + y), rowBytes);
+    return fStaging.data();
+  }
+
+  size_t getPendingBytes() const
+  {
+    size_t bytes = 0;
+    for(auto const &pending: fPending)
+      bytes += pending.getBytes();
+    return bytes;
+  }
+
+private:
+  void add(Upload iUpload)
+  {
+    if(iUpload.fWidth <= 0 || iUpload.fHeight <= 0)
+      return;
+
+    // merges with a pending rectangle of the same texture, which then takes the merged rectangle (and keeps its place
+    // in the queue, being the oldest). The merged rectangle is merged again until no other pending one fits.
+    auto merged = fPending.end();
+    auto area = static_cast<float>(iUpload.fWidth) * iUpload.fHeight;
+    for(auto pending = fPending.begin(); pending != fPending.end();)
+    {
+      if(pending == merged || pending->fTexture != iUpload.fTexture)
+      {
+        ++pending;
+        continue;
+      }
+      auto x0 = std::min(pending->fX, iUpload.fX);
+      auto y0 = std::min(pending->fY, iUpload.fY);
+      auto x1 = std::max(pending->fX + pending->fWidth, iUpload.fX + iUpload.fWidth);
+      auto y1 = std::max(pending->fY + pending->fHeight, iUpload.fY + iUpload.fHeight);
+      auto mergedArea = static_cast<float>(x1 - x0) * (y1 - y0);
+      if(mergedArea > (area + static_cast<float>(pending->fWidth) * pending->fHeight) * kMergeWaste)
+      {
+        ++pending;
+        continue;
+      }
+      iUpload = {iUpload.fTexture, x0, y0, x1 - x0, y1 - y0};
+      area = mergedArea;
+      if(merged == fPending.end() || pending < merged)
+      {
+        if(merged != fPending.end())
+          fPending.erase(merged);
+        *pending = iUpload;
+        merged = pending;
+      }
+      else
+      {
+        fPending.erase(pending);
+        *merged = iUpload;
+      }
+      // the merged rectangle is bigger: starts again
+      pending = fPending.begin();
+    }
+    if(merged == fPending.end())
+      fPending.emplace_back(iUpload);
+  }
+
+  size_t fMaxBytesPerFrame{kDefaultMaxBytesPerFrame};
+  std::vector<Upload> fPending{};
+  std::vector<unsigned char> fStaging{};
+};
+
+#endif // #ifndef IMGUI_DISABLE
@@ -0,0 +1,94 @@
+// Lazy-loaded ImGui demo (lazyDemo=<path of the module> port option, see imgui_lazy_demo.h)
+
+#include "imgui.h"
+#ifndef IMGUI_DISABLE
+
+#include "imgui_lazy_demo.h"
+
+#include <dlfcn.h>
+#include <emscripten/emscripten.h>
+#include <cstdio>
+
+// file name of the side module (defined by the port from the lazyDemo option)
+#ifndef IMGUI_LAZY_DEMO_MODULE
+#define IMGUI_LAZY_DEMO_MODULE "imgui_demo.wasm"
+#endif
+
+namespace {
+
+using ShowDemoWindowFunction = void (*)(bool *);
+
+ImGui_LazyDemo_Status gStatus{ImGui_LazyDemo_Status_NotLoaded};
+ShowDemoWindowFunction gShowDemoWindow{};
+
+//------------------------------------------------------------------------
+// onLoaded / onError (called by emscripten_dlopen between 2 frames)
+//------------------------------------------------------------------------
+void onLoaded(void *, void *iHandle)
+{
+  gShowDemoWindow = reinterpret_cast<ShowDemoWindowFunction>(dlsym(iHandle, "ImGui_LazyDemo_ShowDemoWindowImpl"));
+  if(gShowDemoWindow)
+    gStatus = ImGui_LazyDemo_Status_Loaded;
+  else
+  {
+    fprintf(stderr, "ImGui_LazyDemo: %s is not the demo module (%s)\n", IMGUI_LAZY_DEMO_MODULE, dlerror());
+    gStatus = ImGui_LazyDemo_Status_Failed;
+  }
+}
+
+void onError(void *)
+{
+  fprintf(stderr, "ImGui_LazyDemo: cannot load %s (%s)\n", IMGUI_LAZY_DEMO_MODULE, dlerror());
+  gStatus = ImGui_LazyDemo_Status_Failed;
+}
+
+void load()
+{
+  gStatus = ImGui_LazyDemo_Status_Loading;
+  // RTLD_GLOBAL: the other functions of imgui_demo.cpp (ex: ImGui::ShowStyleEditor) can be called once loaded
+  emscripten_dlopen(IMGUI_LAZY_DEMO_MODULE, RTLD_NOW | RTLD_GLOBAL, nullptr, onLoaded, onError);
+}
+
+}
+
+//------------------------------------------------------------------------
+// ImGui_LazyDemo_ShowDemoWindow
+//------------------------------------------------------------------------
+void ImGui_LazyDemo_ShowDemoWindow(bool *p_open)
+{
+  if(gStatus == ImGui_LazyDemo_Status_Loaded)
+  {
+    gShowDemoWindow(p_open);
+    return;
+  }
+
+  if(gStatus == ImGui_LazyDemo_Status_NotLoaded)
+    load();
+
+  // placeholder with the same name, position and size as the demo window (which then simply replaces it)
+  auto const *viewport = ImGui::GetMainViewport();
+  ImGui::SetNextWindowPos(ImVec2(viewport->WorkPos.x + 650, viewport->WorkPos.y + 20), ImGuiCond_FirstUseEver);
+  ImGui::SetNextWindowSize(ImVec2(550, 680), ImGuiCond_FirstUseEver);
+  if(ImGui::Begin("Dear ImGui Demo", p_open))
+  {
+    if(gStatus == ImGui_LazyDemo_Status_Loading)
+      ImGui::TextDisabled("Loading the demo (%s)...", IMGUI_LAZY_DEMO_MODULE);
+    else
+    {
+      ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Cannot load the demo (%s)", IMGUI_LAZY_DEMO_MODULE);
+      if(ImGui::Button("Try again"))
+        load();
+    }
+  }
+  ImGui::End();
+}
+
+//------------------------------------------------------------------------
+// ImGui_LazyDemo_GetStatus
+//------------------------------------------------------------------------
+ImGui_LazyDemo_Status ImGui_LazyDemo_GetStatus()
+{
+  return gStatus;
+}
+
+#endif // #ifndef IMGUI_DISABLE
@@ -0,0 +1,31 @@
+// Lazy-loaded ImGui demo (lazyDemo=<path of the module> port option)
+//
+// imgui_demo.cpp is the biggest source of ImGui, and is rarely used once an application ships: disableDemo removes it
+// altogether. With lazyDemo, the port instead builds it as a separate side module (imgui_demo.wasm), which is not
+// part of the main wasm and is only fetched (and linked, with emscripten_dlopen, asynchronously) the first time
+// ImGui_LazyDemo_ShowDemoWindow() is called. Until then, a placeholder window is shown in place of the demo.
+//
+// Requires linking the application with -sMAIN_MODULE=2 (the port adds the side module to the link, so that the
+// symbols it uses are exported by the main module) and deploying the module next to the page (the module is
+// fetched by its file name, relative to the page).
+
+#pragma once
+
+#include "imgui.h"
+#ifndef IMGUI_DISABLE
+
+enum ImGui_LazyDemo_Status
+{
+  ImGui_LazyDemo_Status_NotLoaded,
+  ImGui_LazyDemo_Status_Loading,
+  ImGui_LazyDemo_Status_Loaded,
+  ImGui_LazyDemo_Status_Failed  // see the console (ImGui_LazyDemo_ShowDemoWindow offers to try again)
+};
+
+// Replaces ImGui::ShowDemoWindow(): starts loading the demo module on the first call, and shows the demo once loaded.
+// The module is loaded between 2 frames: an event-driven main loop must keep running while the status is Loading.
+void ImGui_LazyDemo_ShowDemoWindow(bool *p_open = nullptr);
+
+ImGui_LazyDemo_Status ImGui_LazyDemo_GetStatus();
+
+#endif // #ifndef IMGUI_DISABLE
@@ -0,0 +1,12 @@
+// Entry point of the demo side module (lazyDemo port option, see imgui_lazy_demo.h), built with imgui_demo.cpp.
+// Looked up by name (dlsym) once the module is loaded: a C symbol avoids depending on the C++ name mangling.
+
+#include "imgui.h"
+#ifndef IMGUI_DISABLE
+
+extern "C" __attribute__((used)) void ImGui_LazyDemo_ShowDemoWindowImpl(bool *p_open)
+{
+  ImGui::ShowDemoWindow(p_open);
+}
+
+#endif // #ifndef IMGUI_DISABLE
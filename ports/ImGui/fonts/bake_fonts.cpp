@@ -0,0 +1,210 @@
+// Bake tool for the bakedFonts port option (see imgui_baked_fonts.h): rasterizes fonts offline into a blob
+// - built with the ImGui core only (backend=none:renderer=none) and run by node (see bake_fonts.py)
+// - uses the same ImGui (stb_truetype) as the application, so the baked glyphs are the ones it would rasterize
+//
+// Usage: node bake_fonts.js -o <blob> [--sizes 13,16] [--scales 1,2] [--densities 1] [--ranges 0x20-0xFF] --font <default|file.ttf> ...
+// Each --font is baked with the --sizes/--scales/--densities/--ranges given before it: every size x scale x density
+// combination (the size used by ImGui is the font size times style.FontScaleDpi, hence the scales).
+
+#include <imgui.h>
+#include <imgui_internal.h>
+#include "imgui_baked_fonts.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct FontSpec
+{
+  std::string fPath;
+  std::vector<float> fSizes;
+  std::vector<float> fScales;
+  std::vector<float> fDensities;
+  std::vector<std::pair<unsigned int, unsigned int>> fRanges;
+};
+
+static std::vector<std::string> Split(std::string const &iValue, char iSeparator)
+{
+  std::vector<std::string> res{};
+  size_t start = 0;
+  while(start <= iValue.size())
+  {
+    auto end = iValue.find(iSeparator, start);
+    if(end == std::string::npos)
+      end = iValue.size();
+    if(end > start)
+      res.emplace_back(iValue.substr(start, end - start));
+    start = end + 1;
+  }
+  return res;
+}
+
+static std::vector<float> ParseFloats(std::string const &iValue)
+{
+  std::vector<float> res{};
+  for(auto const &v: Split(iValue, ','))
+    res.emplace_back(std::strtof(v.c_str(), nullptr));
+  return res;
+}
+
+static std::vector<std::pair<unsigned int, unsigned int>> ParseRanges(std::string const &iValue)
+{
+  std::vector<std::pair<unsigned int, unsigned int>> res{};
+  for(auto const &range: Split(iValue, ','))
+  {
+    auto bounds = Split(range, '-');
+    auto first = static_cast<unsigned int>(std::strtoul(bounds[0].c_str(), nullptr, 0));
+    auto last = bounds.size() > 1 ? static_cast<unsigned int>(std::strtoul(bounds[1].c_str(), nullptr, 0)) : first;
+    res.emplace_back(first, last);
+  }
+  return res;
+}
+
+class Blob
+{
+public:
+  void bakeFont(ImFontAtlas *iAtlas, ImFont *iFont, FontSpec const &iSpec)
+  {
+    auto src = iFont->Sources[0];
+    auto hash = ImGui_BakedFonts_HashFontData(src->FontData, src->FontDataSize);
+    for(auto size: iSpec.fSizes)
+    {
+      for(auto scale: iSpec.fScales)
+      {
+        for(auto density: iSpec.fDensities)
+        {
+          auto baked = iFont->GetFontBaked(size * scale, density);
+          ImGui_BakedFonts_Font font{hash, baked->Size, src->RasterizerDensity * baked->RasterizerDensity,
+                                     static_cast<uint32_t>(fGlyphs.size()), 0};
+          for(auto const &range: iSpec.fRanges)
+          {
+            for(auto c = range.first; c <= range.second && c <= IM_UNICODE_CODEPOINT_MAX; c++)
+            {
+              if(bakeGlyph(iAtlas, baked, static_cast<ImWchar>(c)))
+                font.GlyphCount++;
+            }
+          }
+          printf("%s: %g px (x%g, density %g): %u glyphs\n", iSpec.fPath.c_str(), size, scale, density,
+                 font.GlyphCount);
+          fFonts.emplace_back(font);
+        }
+      }
+    }
+  }
+
+  bool write(char const *iPath) const
+  {
+    ImGui_BakedFonts_Header header{ImGui_BakedFonts_Magic, ImGui_BakedFonts_Version,
+                                   static_cast<uint32_t>(fFonts.size()), static_cast<uint32_t>(fGlyphs.size())};
+    auto file = fopen(iPath, "wb");
+    if(!file)
+      return false;
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(fFonts.data(), sizeof(ImGui_BakedFonts_Font), fFonts.size(), file);
+    fwrite(fGlyphs.data(), sizeof(ImGui_BakedFonts_Glyph), fGlyphs.size(), file);
+    fwrite(fPixels.data(), 1, fPixels.size(), file);
+    fclose(file);
+    printf("%s: %zu fonts, %zu glyphs, %zu bytes\n", iPath, fFonts.size(), fGlyphs.size(),
+           sizeof(header) + fFonts.size() * sizeof(ImGui_BakedFonts_Font) +
+           fGlyphs.size() * sizeof(ImGui_BakedFonts_Glyph) + fPixels.size());
+    return true;
+  }
+
+private:
+  // loads the glyph (rasterized by stb_truetype) and copies it from the atlas (alpha8)
+  bool bakeGlyph(ImFontAtlas *iAtlas, ImFontBaked *iBaked, ImWchar iCodepoint)
+  {
+    auto glyph = iBaked->FindGlyphNoFallback(iCodepoint);
+    if(!glyph || glyph->Codepoint != iCodepoint)
+      return false;
+    ImGui_BakedFonts_Glyph res{iCodepoint, glyph->AdvanceX, glyph->X0, glyph->Y0, glyph->X1, glyph->Y1, 0, 0,
+                               static_cast<uint32_t>(fPixels.size())};
+    if(glyph->Visible && glyph->PackId != ImFontAtlasRectId_Invalid)
+    {
+      auto rect = ImFontAtlasPackGetRect(iAtlas, glyph->PackId);
+      auto tex = iAtlas->TexData;
+      res.Width = rect->w;
+      res.Height = rect->h;
+      for(int y = 0; y < rect->h; y++)
+      {
+        auto row = static_cast<unsigned char const *>(tex->GetPixelsAt(rect->x, rect->y + y));
+        fPixels.insert(fPixels.end(), row, row + rect->w);
+      }
+    }
+    fGlyphs.emplace_back(res);
+    return true;
+  }
+
+  std::vector<ImGui_BakedFonts_Font> fFonts{};
+  std::vector<ImGui_BakedFonts_Glyph> fGlyphs{};
+  std::vector<unsigned char> fPixels{};
+};
+
+int main(int argc, char **argv)
+{
+  char const *output = nullptr;
+  FontSpec spec{"", {13.0f}, {1.0f}, {1.0f}, {{0x20, 0xFF}}};
+  std::vector<FontSpec> fonts{};
+  for(int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    if(i + 1 >= argc)
+    {
+      fprintf(stderr, "Missing value for %s\n", arg.c_str());
+      return 1;
+    }
+    std::string value = argv[++i];
+    if(arg == "-o")
+      output = argv[i];
+    else if(arg == "--sizes")
+      spec.fSizes = ParseFloats(value);
+    else if(arg == "--scales")
+      spec.fScales = ParseFloats(value);
+    else if(arg == "--densities")
+      spec.fDensities = ParseFloats(value);
+    else if(arg == "--ranges")
+      spec.fRanges = ParseRanges(value);
+    else if(arg == "--font")
+    {
+      spec.fPath = value;
+      fonts.emplace_back(spec);
+    }
+    else
+    {
+      fprintf(stderr, "Unknown option %s\n", arg.c_str());
+      return 1;
+    }
+  }
+  if(!output || fonts.empty())
+  {
+    fprintf(stderr, "Usage: bake_fonts -o <blob> [--sizes 13,16] [--scales 1,2] [--densities 1] "
+                    "[--ranges 0x20-0xFF] --font <default|file.ttf> ...\n");
+    return 1;
+  }
+
+  ImGui::CreateContext();
+  ImGuiIO &io = ImGui::GetIO();
+  // the glyphs are loaded in the (cpu) atlas without any renderer
+  io.BackendFlags |= ImGuiBackendFlags_RendererHasTextures;
+  auto atlas = io.Fonts;
+  atlas->TexDesiredFormat = ImTextureFormat_Alpha8;
+
+  Blob blob{};
+  for(auto const &font: fonts)
+  {
+    ImFontConfig config{};
+    config.SizePixels = font.fSizes.empty() ? 13.0f : font.fSizes[0];
+    auto f = font.fPath == "default" ? atlas->AddFontDefault(&config) :
+             atlas->AddFontFromFileTTF(font.fPath.c_str(), config.SizePixels, &config);
+    if(!f)
+    {
+      fprintf(stderr, "Cannot load font %s\n", font.fPath.c_str());
+      return 1;
+    }
+    blob.bakeFont(atlas, f, font);
+  }
+
+  ImGui::DestroyContext();
+  return blob.write(output) ? 0 : 1;
+}
@@ -0,0 +1,47 @@
+# Builds the bake tool (bake_fonts.cpp) and runs it with node to generate the blob used by the bakedFonts port option
+#
+# Usage: python3 bake_fonts.py [options] -o <blob> [--sizes 13,16] [--scales 1,2] [--densities 1] [--ranges 0x20-0xFF] --font <default|file.ttf> ...
+#   --build-dir DIR            where the tool is built (default to /tmp/imgui-bake-fonts)
+#   --port-options a=b:c=d     additional port options (ex: branch=docking), must match the application for the
+#                              glyphs to be identical (same ImGui version)
+# Every other argument is passed to the tool: each --font is baked with the --sizes/--scales/--densities/--ranges
+# given before it (defaults: 13 / 1 / 1 / 0x20-0xFF). Font files are read from the local file system.
+#
+# Example (default font at the scales used by the examples + Japanese at 2 sizes):
+#   python3 bake_fonts.py -o fonts.bin --scales 1,1.5,2 --font default \
+#     --sizes 16,20 --ranges 0x20-0xFF,0x3000-0x30FF,0x31F0-0x31FF,0x4E00-0x9FAF --font NotoSansJP-Regular.ttf
+
+import argparse
+import os
+import subprocess
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+PORT = os.path.abspath(os.path.join(HERE, '..', 'imgui.py'))
+
+
+def build(args):
+    os.makedirs(args.build_dir, exist_ok=True)
+    output = os.path.join(args.build_dir, 'bake_fonts.js')
+    port_options = ':'.join(['backend=none', 'renderer=none'] + ([args.port_options] if args.port_options else []))
+    command = ['emcc', '-O2', '-sALLOW_MEMORY_GROWTH=1', '-sENVIRONMENT=node', '-sNODERAWFS=1',
+               f'--use-port={PORT}:{port_options}', os.path.join(HERE, 'bake_fonts.cpp'), '-o', output]
+    print(' '.join(command), flush=True)
+    subprocess.run(command, check=True)
+    return output
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Bakes fonts for the bakedFonts option of the ImGui port')
+    parser.add_argument('--build-dir', default='/tmp/imgui-bake-fonts')
+    parser.add_argument('--port-options', default='')
+    args, tool_args = parser.parse_known_args()
+
+    tool = build(args)
+    # NODERAWFS: the paths are relative to the current directory
+    res = subprocess.run(['node', tool] + tool_args)
+    sys.exit(res.returncode)
+
+
+if __name__ == '__main__':
+    main()
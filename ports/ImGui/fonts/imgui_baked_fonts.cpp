@@ -0,0 +1,195 @@
+// Pre-baked font glyphs for ImGui (bakedFonts=<path to blob> port option, see imgui_baked_fonts.h)
+
+#include "imgui.h"
+#ifndef IMGUI_DISABLE
+
+#include "imgui_internal.h"
+#include "imgui_baked_fonts.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+// generated by the port from the blob
+extern "C" unsigned char const ImGui_BakedFonts_Data[];
+extern "C" size_t const ImGui_BakedFonts_DataSize;
+
+namespace {
+
+//------------------------------------------------------------------------
+// BakedFonts
+//------------------------------------------------------------------------
+class BakedFonts
+{
+public:
+  bool load(unsigned char const *iData, size_t iSize)
+  {
+    if(iSize < sizeof(ImGui_BakedFonts_Header))
+      return false;
+    auto header = reinterpret_cast<ImGui_BakedFonts_Header const *>(iData);
+    if(header->Magic != ImGui_BakedFonts_Magic || header->Version != ImGui_BakedFonts_Version)
+      return false;
+    auto pixelsOffset = sizeof(ImGui_BakedFonts_Header) + header->FontCount * sizeof(ImGui_BakedFonts_Font) +
+                        header->GlyphCount * sizeof(ImGui_BakedFonts_Glyph);
+    if(iSize < pixelsOffset)
+      return false;
+    fFonts = reinterpret_cast<ImGui_BakedFonts_Font const *>(header + 1);
+    fFontCount = static_cast<int>(header->FontCount);
+    fGlyphs = reinterpret_cast<ImGui_BakedFonts_Glyph const *>(fFonts + fFontCount);
+    fGlyphCount = static_cast<int>(header->GlyphCount);
+    fPixels = iData + pixelsOffset;
+    fPixelsSize = iSize - pixelsOffset;
+    return true;
+  }
+
+  // called when a font source is added to the atlas: its data is hashed once
+  void addSource(ImFontConfig const *iSrc)
+  {
+    std::vector<int> fonts{};
+    auto hash = ImGui_BakedFonts_HashFontData(iSrc->FontData, iSrc->FontDataSize);
+    for(int i = 0; i < fFontCount; i++)
+    {
+      if(fFonts[i].DataHash == hash)
+        fonts.emplace_back(i);
+    }
+    fSources[iSrc] = std::move(fonts);
+  }
+
+  void removeSource(ImFontConfig const *iSrc) { fSources.erase(iSrc); }
+
+  ImGui_BakedFonts_Glyph const *findGlyph(ImFontConfig const *iSrc, ImFontBaked const *iBaked, ImWchar iCodepoint) const
+  {
+    auto source = fSources.find(iSrc);
+    if(source == fSources.end())
+      return nullptr;
+    auto density = iSrc->RasterizerDensity * iBaked->RasterizerDensity;
+    for(auto index: source->second)
+    {
+      auto const &font = fFonts[index];
+      if(std::fabs(font.Size - iBaked->Size) > 1e-3f || std::fabs(font.Density - density) > 1e-3f)
+        continue;
+      // the glyphs of a font are sorted by codepoint
+      auto first = fGlyphs + font.FirstGlyph;
+      auto last = first + font.GlyphCount;
+      auto glyph = std::lower_bound(first, last, static_cast<uint32_t>(iCodepoint),
+                                    [](ImGui_BakedFonts_Glyph const &g, uint32_t c) { return g.Codepoint < c; });
+      if(glyph != last && glyph->Codepoint == iCodepoint &&
+         glyph->PixelsOffset + static_cast<size_t>(glyph->Width) * glyph->Height <= fPixelsSize)
+        return glyph;
+      return nullptr;
+    }
+    return nullptr;
+  }
+
+  unsigned char const *getPixels(ImGui_BakedFonts_Glyph const *iGlyph) const { return fPixels + iGlyph->PixelsOffset; }
+  int getFontCount() const { return fFontCount; }
+  int getGlyphCount() const { return fGlyphCount; }
+
+  ImGui_BakedFonts_Stats fStats{};
+
+private:
+  ImGui_BakedFonts_Font const *fFonts{};
+  int fFontCount{};
+  ImGui_BakedFonts_Glyph const *fGlyphs{};
+  int fGlyphCount{};
+  unsigned char const *fPixels{};
+  size_t fPixelsSize{};
+  std::unordered_map<ImFontConfig const *, std::vector<int>> fSources{};
+};
+
+BakedFonts kBakedFonts{};
+
+// the stb_truetype loader: everything but the glyphs found in the blob is delegated to it
+ImFontLoader const *kStbLoader = nullptr;
+
+//------------------------------------------------------------------------
+// Loader callbacks
+//------------------------------------------------------------------------
+bool BakedFonts_FontSrcInit(ImFontAtlas *iAtlas, ImFontConfig *iSrc)
+{
+  if(!kStbLoader->FontSrcInit(iAtlas, iSrc))
+    return false;
+  kBakedFonts.addSource(iSrc);
+  return true;
+}
+
+void BakedFonts_FontSrcDestroy(ImFontAtlas *iAtlas, ImFontConfig *iSrc)
+{
+  kBakedFonts.removeSource(iSrc);
+  kStbLoader->FontSrcDestroy(iAtlas, iSrc);
+}
+
+bool BakedFonts_FontBakedLoadGlyph(ImFontAtlas *iAtlas, ImFontConfig *iSrc, ImFontBaked *iBaked, void *iLoaderData,
+                                   ImWchar iCodepoint, ImFontGlyph *oGlyph, float *oAdvanceX)
+{
+  auto glyph = kBakedFonts.findGlyph(iSrc, iBaked, iCodepoint);
+  if(!glyph)
+  {
+    auto res = kStbLoader->FontBakedLoadGlyph(iAtlas, iSrc, iBaked, iLoaderData, iCodepoint, oGlyph, oAdvanceX);
+    if(res && oGlyph)
+      kBakedFonts.fStats.RasterizedGlyphs++;
+    return res;
+  }
+
+  // metrics only (the glyph is loaded later, if rendered)
+  if(oAdvanceX)
+  {
+    *oAdvanceX = glyph->AdvanceX;
+    return true;
+  }
+
+  oGlyph->Codepoint = iCodepoint;
+  oGlyph->AdvanceX = glyph->AdvanceX;
+  if(glyph->Width > 0 && glyph->Height > 0)
+  {
+    auto packId = ImFontAtlasPackAddRect(iAtlas, glyph->Width, glyph->Height);
+    if(packId == ImFontAtlasRectId_Invalid)
+      return false;
+    auto rect = ImFontAtlasPackGetRect(iAtlas, packId);
+    oGlyph->X0 = glyph->X0;
+    oGlyph->Y0 = glyph->Y0;
+    oGlyph->X1 = glyph->X1;
+    oGlyph->Y1 = glyph->Y1;
+    oGlyph->Visible = true;
+    oGlyph->PackId = packId;
+    ImFontAtlasBakedSetFontGlyphBitmap(iAtlas, iBaked, iSrc, oGlyph, rect, kBakedFonts.getPixels(glyph),
+                                       ImTextureFormat_Alpha8, glyph->Width);
+  }
+  kBakedFonts.fStats.CopiedGlyphs++;
+  return true;
+}
+
+} // namespace
+
+//------------------------------------------------------------------------
+// API
+//------------------------------------------------------------------------
+bool ImGui_BakedFonts_Install(ImFontAtlas *atlas)
+{
+  if(!kBakedFonts.load(ImGui_BakedFonts_Data, ImGui_BakedFonts_DataSize))
+  {
+    fprintf(stderr, "ImGui_BakedFonts_Install: invalid blob (rebuild it with bake_fonts.py)\n");
+    return false;
+  }
+  kBakedFonts.fStats.BakedFonts = kBakedFonts.getFontCount();
+  kBakedFonts.fStats.BakedGlyphs = kBakedFonts.getGlyphCount();
+
+  static ImFontLoader kLoader{};
+  kStbLoader = ImFontAtlasGetFontLoaderForStbTruetype();
+  kLoader = *kStbLoader;
+  kLoader.Name = "baked+stb_truetype";
+  kLoader.FontSrcInit = BakedFonts_FontSrcInit;
+  kLoader.FontSrcDestroy = BakedFonts_FontSrcDestroy;
+  kLoader.FontBakedLoadGlyph = BakedFonts_FontBakedLoadGlyph;
+  atlas->SetFontLoader(&kLoader);
+  return true;
+}
+
+ImGui_BakedFonts_Stats ImGui_BakedFonts_GetStats()
+{
+  return kBakedFonts.fStats;
+}
+
+#endif // #ifndef IMGUI_DISABLE
@@ -0,0 +1,82 @@
+// Pre-baked font glyphs for ImGui (bakedFonts=<path to blob> port option)
+//
+// ImGui rasterizes the glyphs of its fonts when they are first used (stb_truetype), so the first frames of an
+// application pay for rasterizing every visible glyph (at every size and scale used), which adds up quickly with
+// CJK text or several sizes. The bake tool (bake_fonts.py) rasterizes a set of fonts/sizes/scales/codepoint ranges
+// offline into a compact blob, which the port links into the wasm. ImGui_BakedFonts_Install() then installs a font
+// loader which copies the glyphs found in the blob straight into the atlas, and falls back to stb_truetype for any
+// other glyph (codepoint, size or font which was not baked).
+//
+// A glyph is looked up by the hash of the font data (ImFontConfig::FontData), the size and the rasterizer density:
+// the fonts must be added with the same ImFontConfig (oversampling, glyph offset...) as when they were baked.
+
+#pragma once
+
+#include "imgui.h"
+#ifndef IMGUI_DISABLE
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Installs the baked font loader on the atlas (call it before adding any font). Returns false if the blob linked by
+// the port is invalid, in which case the atlas is left untouched (stb_truetype).
+bool ImGui_BakedFonts_Install(ImFontAtlas *atlas);
+
+struct ImGui_BakedFonts_Stats
+{
+  int BakedFonts;      // number of font/size/density combinations in the blob
+  int BakedGlyphs;     // number of glyphs in the blob
+  int CopiedGlyphs;    // number of glyphs loaded from the blob
+  int RasterizedGlyphs; // number of glyphs rasterized at runtime (not in the blob)
+};
+
+ImGui_BakedFonts_Stats ImGui_BakedFonts_GetStats();
+
+//------------------------------------------------------------------------
+// Blob format (shared with the bake tool), little endian:
+// - ImGui_BakedFonts_Header
+// - ImGui_BakedFonts_Font[FontCount]
+// - ImGui_BakedFonts_Glyph[GlyphCount] (the glyphs of each font are sorted by codepoint)
+// - alpha8 pixels of the visible glyphs (Width * Height bytes each)
+//------------------------------------------------------------------------
+constexpr uint32_t ImGui_BakedFonts_Magic = 0x46424d49; // "IMBF"
+constexpr uint32_t ImGui_BakedFonts_Version = 1;
+
+struct ImGui_BakedFonts_Header
+{
+  uint32_t Magic;
+  uint32_t Version;
+  uint32_t FontCount;
+  uint32_t GlyphCount;
+};
+
+struct ImGui_BakedFonts_Font
+{
+  uint32_t DataHash;   // ImGui_BakedFonts_HashFontData(ImFontConfig::FontData)
+  float Size;          // ImFontBaked::Size
+  float Density;       // ImFontConfig::RasterizerDensity * ImFontBaked::RasterizerDensity
+  uint32_t FirstGlyph;
+  uint32_t GlyphCount;
+};
+
+struct ImGui_BakedFonts_Glyph
+{
+  uint32_t Codepoint;
+  float AdvanceX;
+  float X0, Y0, X1, Y1;
+  uint16_t Width;      // 0 for an invisible glyph (ex: space)
+  uint16_t Height;
+  uint32_t PixelsOffset; // from the start of the pixels section
+};
+
+// FNV-1a
+inline uint32_t ImGui_BakedFonts_HashFontData(void const *data, int size)
+{
+  auto bytes = static_cast<unsigned char const *>(data);
+  uint32_t hash = 2166136261u;
+  for(int i = 0; i < size; i++)
+    hash = (hash ^ bytes[i]) * 16777619u;
+  return hash;
+}
+
+#endif // #ifndef IMGUI_DISABLE
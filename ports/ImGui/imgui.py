@@ -12,7 +12,10 @@
 #
 # @author Yan Pujante
 
+import hashlib
 import os
+import re
+import shutil
 from typing import Union, Dict, Optional
 
 TAG = '1.92.7'
@@ -33,19 +36,35 @@ DESCRIPTION = f'Dear ImGui ({TAG}): Bloat-free Graphical User interface for C++
 LICENSE = 'MIT License'
 
 VALID_OPTION_VALUES = {
-    'renderer': ['opengl3', 'wgpu'],
-    'backend': ['sdl2', 'glfw'],
+    'renderer': ['opengl3', 'webgl2', 'wgpu', 'wgpu-ring', 'none'],
+    'backend': ['sdl2', 'glfw', 'none'],
     'branch': DISTRIBUTIONS.keys(),
     'disableDemo': ['true', 'false'],
     'disableImGuiStdLib': ['true', 'false'],
     'disableDefaultFont': ['true', 'false'],
+    'unity': ['true', 'false'],
+    'threads': ['true', 'false'],
+    'drawIdx': ['16', '32'],
+    'compactVertex': ['true', 'false'],
     'optimizationLevel': ['0', '1', '2', '3', 'g', 's', 'z']  # all -OX possibilities
 }
 
+# renderers provided by this port (in the backends folder next to this file) instead of ImGui
+PORT_DIR = os.path.dirname(os.path.abspath(__file__))
+PORT_RENDERERS = {
+    'webgl2': {'src': 'imgui_impl_webgl2.cpp', 'define': 'IMGUI_IMPL_WEBGL2'},
+    'wgpu-ring': {'src': 'imgui_impl_wgpu_ring.cpp', 'define': 'IMGUI_IMPL_WGPU_RING'}
+}
+
+WGPU_RENDERERS = {'wgpu', 'wgpu-ring'}
+
 # key is backend, value is set of possible renderers
 VALID_RENDERERS = {
-    'glfw': {'opengl3', 'wgpu'},
-    'sdl2': {'opengl3'}
+    'glfw': {'opengl3', 'webgl2', 'wgpu', 'wgpu-ring'},
+    'sdl2': {'opengl3', 'webgl2'},
+    # ImGui core only (ex: headless benchmark), or with a renderer when the application provides its own platform
+    # layer and WebGL context (ex: rendering in a pthread)
+    'none': {'none', 'opengl3', 'webgl2'}
 }
 
 OPTIONS = {
@@ -55,9 +74,22 @@ OPTIONS = {
     'disableDemo': 'A boolean to disable ImGui demo (enabled by default)',
     'disableImGuiStdLib': 'A boolean to disable misc/cpp/imgui_stdlib.cpp (enabled by default)',
     'disableDefaultFont': 'A boolean to disable the default font (enabled by default)',
+    'unity': 'A boolean to compile all sources as a single translation unit (disabled by default)',
+    'threads': 'A boolean to build the library with threads support (-pthread) (disabled by default)',
+    'drawIdx': f'Size (in bits) of the ImDrawIdx index type: {VALID_OPTION_VALUES["drawIdx"]} (default to 16)',
+    'compactVertex': 'A boolean to store the uv of ImDrawVert as 2 x unorm16 (16 bytes vertex instead of 20) (disabled by default)',
     'optimizationLevel': f'Optimization level: {VALID_OPTION_VALUES["optimizationLevel"]} (default to 2)',
+    'imconfig': 'Path to a user config header (IMGUI_USER_CONFIG) used to build the library and your code',
+    'bakedFonts': 'Path to a font blob generated by fonts/bake_fonts.py, linked with the library (see ImGui_BakedFonts_Install)',
+    'lazyDemo': 'Path where the link writes the ImGui demo built as a side module, loaded on first use (see ImGui_LazyDemo_ShowDemoWindow)',
 }
 
+# options whose value is a path (not checked against VALID_OPTION_VALUES, and case preserved)
+PATH_OPTIONS = {'imconfig', 'bakedFonts'}
+
+# options whose value is the path of a file generated by the port (its directory must exist)
+OUTPUT_PATH_OPTIONS = {'lazyDemo'}
+
 # user options (from --use-port)
 opts: Dict[str, Union[Optional[str], bool]] = {
     'renderer': None,
@@ -66,7 +98,14 @@ opts: Dict[str, Union[Optional[str], bool]] = {
     'disableDemo': False,
     'disableImGuiStdLib': False,
     'disableDefaultFont': False,
-    'optimizationLevel': '2'
+    'unity': False,
+    'threads': False,
+    'drawIdx': '16',
+    'compactVertex': False,
+    'optimizationLevel': '2',
+    'imconfig': None,
+    'bakedFonts': None,
+    'lazyDemo': None
 }
 
 deps = []
@@ -82,12 +121,298 @@ def get_zip_url():
     return f'https://github.com/ocornut/imgui/archive/refs/tags/v{get_tag()}.zip'
 
 
-def get_lib_name(settings):
-    return (f'lib_{port_name}_{get_tag()}-{opts["backend"]}-{opts["renderer"]}-O{opts["optimizationLevel"]}' +
-            ('-nd' if opts['disableDemo'] else '') +
-            ('-nl' if opts['disableImGuiStdLib'] else '') +
-            ('-nf' if opts['disableDefaultFont'] else '') +
-            '.a')
+# ImDrawVert with the uv stored as 2 x unorm16 (16 bytes instead of 20). ImGui writes the uv either as an ImVec2
+# or component by component (ex: vtx.uv.x = u1), hence the conversion operators.
+COMPACT_VERTEX_LAYOUT = r"""
+#define IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT \
+  struct ImDrawVertUNorm16 \
+  { \
+    unsigned short v; \
+    ImDrawVertUNorm16 &operator=(float f) { v = f <= 0.0f ? 0 : f >= 1.0f ? 65535 : (unsigned short) (f * 65535.0f + 0.5f); return *this; } \
+    operator float() const { return (float) v * (1.0f / 65535.0f); } \
+  }; \
+  struct ImDrawVertUV \
+  { \
+    ImDrawVertUNorm16 x, y; \
+    ImDrawVertUV &operator=(const ImVec2 &uv) { x = uv.x; y = uv.y; return *this; } \
+    operator ImVec2() const { return ImVec2(x, y); } \
+  }; \
+  struct ImDrawVert \
+  { \
+    ImVec2 pos; \
+    ImDrawVertUV uv; \
+    ImU32 col; \
+  }
+"""
+
+# With compactVertex=true, the sources which depend on the uv type are patched (regex, replacement): the renderers
+# declare the uv vertex attribute as 2 x normalized unsigned short, and the vertex dump of the debug tools converts
+# the uv to float (printf arguments)
+COMPACT_VERTEX_PATCHES = {
+    'imgui.cpp': [
+        (r'v\.uv\.x,\s*v\.uv\.y', '(float) v.uv.x, (float) v.uv.y')
+    ],
+    'backends/imgui_impl_opengl3.cpp': [
+        (r'(AttribLocationVtxUV\s*,\s*2\s*,\s*)GL_FLOAT(\s*,\s*)GL_FALSE', r'\1GL_UNSIGNED_SHORT\2GL_TRUE')
+    ],
+    'backends/imgui_impl_wgpu.cpp': [
+        (r'WGPUVertexFormat_Float32x2(\s*,\s*(?:\(uint64_t\)\s*)?offsetof\(ImDrawVert,\s*uv\))', r'WGPUVertexFormat_Unorm16x2\1')
+    ]
+}
+
+
+def get_config_lines():
+    # configuration generated from the port options (on top of the user imconfig if any)
+    lines = []
+    if opts['drawIdx'] == '32':
+        lines.append('#define ImDrawIdx unsigned int')
+    if opts['compactVertex']:
+        lines += COMPACT_VERTEX_LAYOUT.strip().splitlines()
+    return lines
+
+
+def get_config_header(ports):
+    # returns the header to use as IMGUI_USER_CONFIG (None if there is no configuration)
+    lines = get_config_lines()
+    if not lines:
+        return opts['imconfig']
+
+    content = '// Generated by imgui.py from the port options\n#pragma once\n'
+    if opts['imconfig']:
+        content += f'#include "{opts["imconfig"].replace(os.sep, "/")}"\n'
+    content += '\n'.join(lines) + '\n'
+
+    # the name depends on the content, so that concurrent builds with different options do not share it
+    digest = hashlib.sha256(content.encode()).hexdigest()[:16]
+    header = os.path.join(ports.get_dir(), port_name, 'config', f'imconfig-{digest}.h')
+    if not os.path.exists(header):
+        os.makedirs(os.path.dirname(header), exist_ok=True)
+        with open(header, 'w') as f:
+            f.write(content)
+    return header
+
+
+def get_config_flags(ports):
+    # the configuration must be seen by the library and by the code using it (ex: ImDrawIdx)
+    header = get_config_header(ports)
+    return [f'-DIMGUI_USER_CONFIG="{header.replace(os.sep, "/")}"'] if header else []
+
+
+def get_config_hash():
+    # identifies the configuration by its content (and not by the path of the headers)
+    h = hashlib.sha256('\n'.join(get_config_lines()).encode())
+    if opts['imconfig']:
+        with open(opts['imconfig'], 'rb') as f:
+            h.update(f.read())
+    return h.hexdigest()
+
+
+def get_patches(srcs):
+    patches = COMPACT_VERTEX_PATCHES if opts['compactVertex'] else {}
+    return {src: patches[src.replace(os.sep, '/')] for src in srcs if src.replace(os.sep, '/') in patches}
+
+
+def create_patched_source(source_path, patched_path, src, patches):
+    with open(os.path.join(source_path, src)) as f:
+        content = f.read()
+    for pattern, replacement in patches:
+        content, count = re.subn(pattern, replacement, content)
+        if count == 0:
+            from tools import utils
+            utils.exit_with_error(f'imgui port: cannot patch {src} (pattern [{pattern}] not found)')
+    patched_src = os.path.join(patched_path, src)
+    os.makedirs(os.path.dirname(patched_src), exist_ok=True)
+    if not os.path.exists(patched_src) or open(patched_src).read() != content:
+        with open(patched_src, 'w') as f:
+            f.write(content)
+    return patched_src
+
+
+# Optional directory containing prebuilt libraries (copied from the emscripten cache of another machine, see
+# README). It is only read: a library found there is used as is instead of being built.
+PREBUILT_CACHE_ENV = 'EMSCRIPTEN_PORTS_IMGUI_PREBUILT_CACHE'
+
+
+def get_build_flags_suffix(settings):
+    # flags which change the generated code (and must be the same for all the libraries)
+    return (f'-O{opts["optimizationLevel"]}' +
+            ('-lto' if settings.LTO else '') +
+            ('-mt' if opts['threads'] else '') +
+            ('-i32' if opts['drawIdx'] == '32' else '') +
+            ('-cv' if opts['compactVertex'] else '') +
+            ('-pic' if settings.RELOCATABLE else ''))
+
+
+def get_build_flags():
+    flags = [f'-O{opts["optimizationLevel"]}', '-Wno-nontrivial-memaccess']
+
+    if opts['threads']:
+        flags.append('-pthread')
+
+    return flags
+
+
+def get_renderer_src():
+    if opts['renderer'] in PORT_RENDERERS:
+        return os.path.join(PORT_DIR, 'backends', PORT_RENDERERS[opts['renderer']]['src'])
+    return os.path.join('backends', f'imgui_impl_{opts["renderer"]}.cpp')
+
+
+def get_port_sources_hash(srcs):
+    # the sources provided by this port are identified by their content (as well as the headers next to them)
+    dirs = sorted({os.path.dirname(src) for src in srcs if os.path.isabs(src)})
+    if not dirs:
+        return ''
+    h = hashlib.sha256()
+    for path in dirs:
+        for name in sorted(os.listdir(path)):
+            h.update(name.encode())
+            with open(os.path.join(path, name), 'rb') as f:
+                h.update(f.read())
+    return h.hexdigest()
+
+
+def get_baked_fonts_hash(recipe):
+    # the blob is identified by its content (and not by its path)
+    if not recipe.get('bakedFonts'):
+        return ''
+    with open(recipe['bakedFonts'], 'rb') as f:
+        return hashlib.sha256(f.read()).hexdigest()
+
+
+def create_baked_fonts_source(ports, blob):
+    # the blob is linked as a C array (ImGui_BakedFonts_Data, see fonts/imgui_baked_fonts.cpp)
+    with open(blob, 'rb') as f:
+        data = f.read()
+    digest = hashlib.sha256(data).hexdigest()[:16]
+    src = os.path.join(ports.get_dir(), port_name, 'fonts', f'baked_fonts-{digest}.cpp')
+    if not os.path.exists(src):
+        lines = [', '.join(f'0x{byte:02x}' for byte in data[i:i + 16]) for i in range(0, len(data), 16)]
+        content = (f'// Generated by imgui.py from {os.path.basename(blob)}\n'
+                   '#include <stddef.h>\n'
+                   'extern "C" alignas(4) unsigned char const ImGui_BakedFonts_Data[] = {\n' +
+                   ',\n'.join(lines) + '\n};\n'
+                   'extern "C" size_t const ImGui_BakedFonts_DataSize = sizeof(ImGui_BakedFonts_Data);\n')
+        os.makedirs(os.path.dirname(src), exist_ok=True)
+        with open(src, 'w') as f:
+            f.write(content)
+    return src
+
+
+# The ImGui core (which is the bulk of the compilation) does not depend on the backend or renderer, so it is built
+# in its own library, shared by all backend/renderer combinations. The backend and renderer are built in
+# (small) separate libraries.
+# Returns the recipe (name prefix, sources, flags) of each library to build, in link order.
+def get_recipes(settings):
+    prefix = f'lib_{port_name}_{get_tag()}'
+    suffix = get_build_flags_suffix(settings)
+    flags = get_build_flags()
+
+    # the backend and renderer need the headers of the dependencies (the core does not)
+    deps_flags = [f'--use-port={value}' for value in deps]
+
+    recipes = []
+
+    if opts['backend'] != 'none':
+        recipes.append({
+            'prefix': f'{prefix}-backend-{opts["backend"]}{suffix}',
+            'srcs': [os.path.join('backends', f'imgui_impl_{opts["backend"]}.cpp')],
+            'flags': deps_flags + flags
+        })
+
+    if opts['renderer'] != 'none':
+        recipes.append({
+            'prefix': f'{prefix}-renderer-{opts["renderer"]}{suffix}',
+            'srcs': [get_renderer_src()],
+            'flags': deps_flags + flags
+        })
+
+    if opts['bakedFonts']:
+        recipes.append({
+            'prefix': f'{prefix}-baked-fonts{suffix}',
+            'srcs': [os.path.join(PORT_DIR, 'fonts', 'imgui_baked_fonts.cpp')],
+            'flags': flags,
+            'bakedFonts': opts['bakedFonts']
+        })
+
+    if opts['lazyDemo']:
+        # the demo is built as a side module (see below): this library loads it the first time it is shown
+        recipes.append({
+            'prefix': f'{prefix}-lazy-demo{suffix}',
+            'srcs': [os.path.join(PORT_DIR, 'demo', 'imgui_lazy_demo.cpp')],
+            'flags': flags + [f'-DIMGUI_LAZY_DEMO_MODULE="{os.path.basename(opts["lazyDemo"])}"']
+        })
+
+    srcs = ['imgui.cpp', 'imgui_draw.cpp', 'imgui_tables.cpp', 'imgui_widgets.cpp']
+    if not opts['disableDemo'] and not opts['lazyDemo']:
+        srcs.append('imgui_demo.cpp')
+    if not opts['disableImGuiStdLib']:
+        srcs.append('misc/cpp/imgui_stdlib.cpp')
+
+    core_flags = flags.copy()
+    if opts['disableDefaultFont']:
+        core_flags.append('-DIMGUI_DISABLE_DEFAULT_FONT')
+
+    recipes.append({
+        'prefix': (f'{prefix}-core{suffix}' +
+                   ('-nd' if opts['disableDemo'] or opts['lazyDemo'] else '') +
+                   ('-nl' if opts['disableImGuiStdLib'] else '') +
+                   ('-nf' if opts['disableDefaultFont'] else '') +
+                   ('-u' if opts['unity'] else '')),
+        'srcs': srcs,
+        'flags': core_flags,
+        'unity': opts['unity']
+    })
+
+    if opts['lazyDemo']:
+        # linked as a shared library: the main module exports the symbols it uses, and loads it on demand
+        # (compiled with the same flags as the core, since it uses the same ImGui structures)
+        recipes.append({
+            'prefix': f'{prefix}-demo-module{suffix}',
+            'srcs': ['imgui_demo.cpp', os.path.join(PORT_DIR, 'demo', 'imgui_lazy_demo_module.cpp')],
+            'flags': core_flags,
+            'sideModule': True
+        })
+
+    for recipe in recipes:
+        recipe['patches'] = get_patches(recipe['srcs'])
+
+    return recipes
+
+
+def get_lib_name(recipe, settings, shared):
+    # the name contains a hash of every input of the build, so a library is rebuilt when (and only when) one of
+    # them changes (ex: new ImGui version, different flags or a new emscripten version)
+    # the config header is identified by its content (not its path)
+    inputs = [recipe['prefix'], TAG, get_tag(), DISTRIBUTIONS[opts['branch']]['hash'], shared.EMSCRIPTEN_VERSION,
+              *[f'{setting}={getattr(settings, setting, 0)}' for setting in ['LTO', 'RELOCATABLE', 'MEMORY64']],
+              *[os.path.relpath(src, PORT_DIR) if os.path.isabs(src) else src for src in recipe['srcs']],
+              get_port_sources_hash(recipe['srcs']), *recipe['flags'], repr(sorted(recipe['patches'].items())),
+              get_config_hash(), get_baked_fonts_hash(recipe)]
+    digest = hashlib.sha256('\0'.join(str(value) for value in inputs).encode()).hexdigest()
+    return f'{recipe["prefix"]}-{digest[:16]}{".wasm" if recipe.get("sideModule") else ".a"}'
+
+
+def get_prebuilt_lib(name):
+    prebuilt_cache = os.environ.get(PREBUILT_CACHE_ENV)
+    if prebuilt_cache:
+        lib = os.path.join(prebuilt_cache, name)
+        if os.path.isfile(lib):
+            return lib
+    return None
+
+
+def create_unity_source(ports, source_path, srcs, name):
+    # a single translation unit including every source lets the optimizer see across files
+    # (ex: ImDrawList primitives can be inlined in the widgets code)
+    # it is generated outside of the source tree (shared by all the variants), and named after the library
+    unity_src = os.path.join(ports.get_dir(), port_name, 'unity', f'{name}.unity.cpp')
+    content = ''.join(f'#include "{os.path.join(source_path, src).replace(os.sep, "/")}"\n' for src in srcs)
+    os.makedirs(os.path.dirname(unity_src), exist_ok=True)
+    if not os.path.exists(unity_src) or open(unity_src).read() != content:
+        with open(unity_src, 'w') as f:
+            f.write(content)
+    return unity_src
 
 
 def get(ports, settings, shared):
@@ -96,42 +421,81 @@ def get(ports, settings, shared):
     if opts['backend'] is None or opts['renderer'] is None:
         utils.exit_with_error(f'imgui port requires both backend and renderer options to be defined')
 
-    ports.fetch_project(port_name, get_zip_url(), sha512hash=DISTRIBUTIONS[opts['branch']]['hash'])
-
-    def create(final):
-        root_path = os.path.join(ports.get_dir(), port_name, f'imgui-{get_tag()}')
-        source_path = root_path
-
-        # this port does not install the headers on purpose (see process_args)
-        # a) there is no need (simply refer to the unzipped content)
-        # b) avoids any potential issue between docking/master headers being different
-
-        srcs = ['imgui.cpp', 'imgui_draw.cpp', 'imgui_tables.cpp', 'imgui_widgets.cpp']
-        if not opts['disableDemo']:
-            srcs.append('imgui_demo.cpp')
-        if not opts['disableImGuiStdLib']:
-            srcs.append('misc/cpp/imgui_stdlib.cpp')
-        srcs.append(os.path.join('backends', f'imgui_impl_{opts["backend"]}.cpp'))
-        srcs.append(os.path.join('backends', f'imgui_impl_{opts["renderer"]}.cpp'))
-
-        flags = [f'--use-port={value}' for value in deps]
-        flags.append(f'-O{opts["optimizationLevel"]}')
-        flags.append('-Wno-nontrivial-memaccess')
-
-        if opts['disableDefaultFont']:
-            flags.append('-DIMGUI_DISABLE_DEFAULT_FONT')
+    # the dependencies (glfw3/sdl2) are built based on -pthread, so the library must match to avoid mixing
+    # objects compiled with and without threads support
+    if opts['threads'] and not settings.PTHREADS:
+        utils.exit_with_error(f'imgui port option threads=true requires linking with -pthread')
+    if settings.PTHREADS and not opts['threads']:
+        utils.exit_with_error(f'imgui port requires the threads=true option when linking with -pthread')
+
+    # the demo side module can only be loaded by a main module (which exports the symbols it uses)
+    if opts['lazyDemo'] and settings.MAIN_MODULE != 2:
+        utils.exit_with_error(f'imgui port option lazyDemo requires linking with -sMAIN_MODULE=2')
+
+    libs = []
+    recipes = []
+    for recipe in get_recipes(settings):
+        name = get_lib_name(recipe, settings, shared)
+        prebuilt_lib = get_prebuilt_lib(name)
+        if prebuilt_lib:
+            libs.append(prebuilt_lib)
+        else:
+            libs.append(name)
+            recipes.append((name, recipe))
 
-        ports.build_port(source_path, final, port_name, srcs=srcs, flags=flags)
+    # the sources are always needed for the headers (see process_args)
+    ports.fetch_project(port_name, get_zip_url(), sha512hash=DISTRIBUTIONS[opts['branch']]['hash'])
 
-    lib = shared.cache.get_lib(get_lib_name(settings), create, what='port')
-    if os.path.getmtime(lib) < os.path.getmtime(__file__):
-        clear(ports, settings, shared)
-        lib = shared.cache.get_lib(get_lib_name(settings), create, what='port')
-    return [lib]
+    # this port does not install the headers on purpose (see process_args)
+    # a) there is no need (simply refer to the unzipped content)
+    # b) avoids any potential issue between docking/master headers being different
+    source_path = os.path.join(ports.get_dir(), port_name, f'imgui-{get_tag()}')
+
+    def creator(recipe):
+        def create(final):
+            srcs = recipe['srcs']
+            # the patched sources are generated outside of the source tree (the original ones stay untouched)
+            if recipe['patches']:
+                patched_path = os.path.join(ports.get_dir(), port_name, 'patched', recipe['prefix'])
+                srcs = [create_patched_source(source_path, patched_path, src, recipe['patches'][src])
+                        if src in recipe['patches'] else src for src in srcs]
+            if recipe.get('unity'):
+                srcs = [create_unity_source(ports, source_path, srcs, recipe['prefix'])]
+            if recipe.get('bakedFonts'):
+                srcs = srcs + [create_baked_fonts_source(ports, recipe['bakedFonts'])]
+            # the patched sources still include the original headers (ex: #include "imgui.h")
+            flags = ['-I', source_path, '-I', os.path.join(source_path, 'backends')] + recipe['flags'] + \
+                    get_config_flags(ports)
+            if recipe.get('sideModule'):
+                # ports.build_port only builds static libraries: the objects are compiled by it (with the same
+                # base flags as the other libraries, ex: -flto), then linked as a side module
+                archive = os.path.join(ports.get_build_dir(), port_name, f'{recipe["prefix"]}.a')
+                ports.build_port(source_path, archive, port_name, srcs=srcs, flags=flags)
+                link_flags = ['-sSIDE_MODULE=1', f'-O{opts["optimizationLevel"]}']
+                if settings.LTO:
+                    link_flags.append(f'-flto={settings.LTO}')
+                if settings.MEMORY64:
+                    link_flags.append(f'-sMEMORY64={settings.MEMORY64}')
+                shared.check_call([shared.EMCC] + link_flags +
+                                  ['-Wl,--whole-archive', archive, '-Wl,--no-whole-archive', '-o', final])
+            else:
+                ports.build_port(source_path, final, port_name, srcs=srcs, flags=flags)
+        return create
+
+    for name, recipe in recipes:
+        libs[libs.index(name)] = shared.cache.get_lib(name, creator(recipe), what='port')
+
+    # the demo module is an output of the link (like the .wasm of the application): it is written (from the cache)
+    # every time the application is linked, and deployed with it (fetched at runtime by its file name)
+    # note: this cannot be done in linker_setup, which runs before the libraries are built
+    if opts['lazyDemo']:
+        shutil.copyfile(next(lib for lib in libs if lib.endswith('.wasm')), opts['lazyDemo'])
+    return libs
 
 
 def clear(ports, settings, shared):
-    shared.cache.erase_lib(get_lib_name(settings))
+    for recipe in get_recipes(settings):
+        shared.cache.erase_lib(get_lib_name(recipe, settings, shared))
 
 
 def process_args(ports):
@@ -141,14 +505,31 @@ def process_args(ports):
         args += ['-DIMGUI_ENABLE_DOCKING=1']
     if opts['disableDemo']:
         args += ['-DIMGUI_DISABLE_DEMO=1']
+    if opts['lazyDemo']:
+        # makes the lazy demo API accessible (#include <imgui_lazy_demo.h>)
+        args += ['-I', os.path.join(PORT_DIR, 'demo'), '-DIMGUI_LAZY_DEMO=1']
+    if opts['renderer'] in PORT_RENDERERS:
+        # makes the headers of the port renderer accessible (ex: #include <imgui_impl_wgpu_ring.h>)
+        args += ['-I', os.path.join(PORT_DIR, 'backends'), f'-D{PORT_RENDERERS[opts["renderer"]]["define"]}=1']
+    if opts['bakedFonts']:
+        # makes the baked fonts API accessible (#include <imgui_baked_fonts.h>)
+        args += ['-I', os.path.join(PORT_DIR, 'fonts'), '-DIMGUI_BAKED_FONTS=1']
+    args += get_config_flags(ports)
     return args
 
 
 def linker_setup(ports, settings):
-    if opts['backend'] == 'glfw':
+    # the webgl2 renderer only supports a WebGL2 context (and without backend, the application creates a WebGL2
+    # context)
+    if (opts['backend'] == 'glfw' or opts['renderer'] == 'webgl2' or
+            (opts['backend'] == 'none' and opts['renderer'] != 'none')):
         settings.MIN_WEBGL_VERSION = 2
         settings.MAX_WEBGL_VERSION = 2
 
+    # the demo module is only loaded when first shown (and not when the application starts)
+    if opts['lazyDemo']:
+        settings.AUTOLOAD_DYLIBS = 0
+
 
 def check_option(option, value, error_handler):
     if value not in VALID_OPTION_VALUES[option]:
@@ -166,6 +547,18 @@ def check_required_option(option, value, error_handler):
 
 def handle_options(options, error_handler):
     for option, value in options.items():
+        if option in PATH_OPTIONS:
+            path = os.path.abspath(os.path.expanduser(value))
+            if not os.path.isfile(path):
+                error_handler(f'[{option}] file not found [{value}]')
+            opts[option] = path
+            continue
+        if option in OUTPUT_PATH_OPTIONS:
+            path = os.path.abspath(os.path.expanduser(value))
+            if not os.path.isdir(os.path.dirname(path)):
+                error_handler(f'[{option}] directory not found [{value}]')
+            opts[option] = path
+            continue
         value = value.lower()
         if option == 'renderer' or option == 'backend':
             opts[option] = check_required_option(option, value, error_handler)
@@ -178,14 +571,20 @@ def handle_options(options, error_handler):
     if opts['renderer'] not in VALID_RENDERERS[opts['backend']]:
         error_handler(f'backend [{opts["backend"]}] does not support [{opts["renderer"]}] renderer')
 
+    if opts['lazyDemo'] and opts['disableDemo']:
+        error_handler(f'lazyDemo and disableDemo cannot be used together')
+    # emscripten does not support dynamic linking with threads (side modules must be loaded by every thread)
+    if opts['lazyDemo'] and opts['threads']:
+        error_handler(f'lazyDemo does not support threads=true')
+
     if opts['backend'] == 'glfw':
         glfw3_options = {'optimizationLevel': opts['optimizationLevel']}
-        if opts['renderer'] == 'wgpu':
+        if opts['renderer'] in WGPU_RENDERERS:
           glfw3_options['disableWebGL2'] = 'true'
           deps.append('emdawnwebgpu')
         glfw3_options = ':'.join(f"{key}={value}" for key, value in glfw3_options.items())
         deps.append(f"contrib.glfw3:{glfw3_options}")
-    else:
+    elif opts['backend'] == 'sdl2':
         deps.append('sdl2')
 
 if __name__ == "__main__":